@@ -8,11 +8,14 @@
 
 namespace BinaryData
 {
-    extern const char*   Pluginbackground_jpg;
-    const int            Pluginbackground_jpgSize = 1160495;
+    extern const char*   Pluginbackground1x_jpg;
+    const int            Pluginbackground1x_jpgSize = 114174;
+
+    extern const char*   Pluginbackground2x_jpg;
+    const int            Pluginbackground2x_jpgSize = 328507;
 
     // Number of elements in the namedResourceList and originalFileNames arrays.
-    const int namedResourceListSize = 1;
+    const int namedResourceListSize = 2;
 
     // Points to the start of a list of resource names.
     extern const char* namedResourceList[];
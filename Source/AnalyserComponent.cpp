@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    AnalyserComponent.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "AnalyserComponent.h"
+
+namespace
+{
+    constexpr float minDb = -100.0f;
+    constexpr float maxDb = 0.0f;
+    constexpr float minFreq = 20.0f;
+}
+
+AnalyserComponent::AnalyserComponent(AudioFifo& fifo)
+    : audioFifo(fifo)
+    , history((size_t) fftSize, 0.0f)
+    , incoming((size_t) fftSize, 0.0f)
+    , fftData((size_t) (2 * fftSize), 0.0f)
+    , spectrumDb((size_t) (fftSize / 2), minDb)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+AnalyserComponent::~AnalyserComponent()
+{
+    audioFifo.setActive(false);
+}
+
+void AnalyserComponent::visibilityChanged()
+{
+    // Solo se piden samples al hilo de audio mientras el panel está a la vista
+    audioFifo.setActive(isVisible());
+
+    if (isVisible())
+        startTimerHz(30);
+    else
+        stopTimer();
+}
+
+void AnalyserComponent::timerCallback()
+{
+    pullSamples();
+    computeSpectrum();
+    repaint();
+}
+
+void AnalyserComponent::pullSamples()
+{
+    int numRead;
+
+    while ((numRead = audioFifo.pop(incoming.data(), (int) incoming.size())) > 0) {
+        for (int i = 0; i < numRead; i++) {
+            history[(size_t) historyPos] = incoming[(size_t) i];
+            historyPos = (historyPos + 1) % fftSize;
+        }
+    }
+}
+
+void AnalyserComponent::computeSpectrum()
+{
+    // Se ordena el buffer circular (del sample más antiguo al más reciente)
+    std::fill(fftData.begin(), fftData.end(), 0.0f);
+    for (int i = 0; i < fftSize; i++)
+        fftData[(size_t) i] = history[(size_t) ((historyPos + i) % fftSize)];
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // Normalización: ventana de Hann (ganancia 0.5) y mitad del espectro
+    const float norm = 4.0f / (float) fftSize;
+
+    for (size_t bin = 0; bin < spectrumDb.size(); bin++) {
+        const float db = juce::jlimit(minDb, maxDb, juce::Decibels::gainToDecibels(fftData[bin] * norm, minDb));
+        spectrumDb[bin] = db > spectrumDb[bin] ? db : 0.8f * spectrumDb[bin] + 0.2f * db;     // Ataque inmediato, caída suave
+    }
+}
+
+void AnalyserComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(0.75f));
+
+    auto area = getLocalBounds().toFloat().reduced(4.0f);
+    auto scopeArea = area.removeFromTop(area.getHeight() * 0.4f);
+    area.removeFromTop(4.0f);
+
+    drawScope(g, scopeArea);
+    drawSpectrum(g, area);
+}
+
+void AnalyserComponent::drawScope(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    g.setColour(juce::Colours::darkgrey);
+    g.drawHorizontalLine((int) area.getCentreY(), area.getX(), area.getRight());
+
+    // Disparo en el último paso por cero ascendente para que la forma de onda no baile
+    const int newest = historyPos + fftSize - 1;
+    int start = newest - scopeSize + 1;
+
+    for (int i = start; i > newest - fftSize + 1; i--) {
+        if (history[(size_t) ((i - 1) % fftSize)] < 0.0f && history[(size_t) (i % fftSize)] >= 0.0f) {
+            start = i;
+            break;
+        }
+    }
+
+    juce::Path p;
+    for (int i = 0; i < scopeSize; i++) {
+        const float sample = juce::jlimit(-1.0f, 1.0f, history[(size_t) ((start + i) % fftSize)]);
+        const float x = area.getX() + area.getWidth() * (float) i / (float) (scopeSize - 1);
+        const float y = area.getCentreY() - sample * area.getHeight() * 0.5f;
+
+        if (i == 0)
+            p.startNewSubPath(x, y);
+        else
+            p.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::lightgreen);
+    g.strokePath(p, juce::PathStrokeType(1.0f));
+}
+
+void AnalyserComponent::drawSpectrum(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const float sampleRate = (float) audioFifo.getSampleRate();
+    const float maxFreq = sampleRate / 2.0f;
+
+    auto freqToX = [&](float f) {
+        return area.getX() + area.getWidth() * std::log(f / minFreq) / std::log(maxFreq / minFreq);
+    };
+
+    // Rejilla: décadas en frecuencia y pasos de 20 dB
+    g.setColour(juce::Colours::darkgrey.withAlpha(0.6f));
+    for (float f = 100.0f; f < maxFreq; f *= 10.0f)
+        g.drawVerticalLine((int) freqToX(f), area.getY(), area.getBottom());
+    for (float db = maxDb - 20.0f; db > minDb; db -= 20.0f)
+        g.drawHorizontalLine((int) juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY()), area.getX(), area.getRight());
+
+    juce::Path p;
+    bool started = false;
+
+    for (size_t bin = 1; bin < spectrumDb.size(); bin++) {
+        const float f = (float) bin * sampleRate / (float) fftSize;
+        if (f < minFreq)
+            continue;
+
+        const float x = freqToX(f);
+        const float y = juce::jmap(spectrumDb[bin], minDb, maxDb, area.getBottom(), area.getY());
+
+        if (!started) {
+            p.startNewSubPath(x, y);
+            started = true;
+        }
+        else
+            p.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(p, juce::PathStrokeType(1.0f));
+}
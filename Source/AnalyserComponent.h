@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    AnalyserComponent.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioFifo.h"
+
+// Osciloscopio y analizador de espectro de la salida del plugin. Todo el
+// cálculo (FFT incluida) se hace en el hilo del UI con los samples que el
+// hilo de audio deja en el AudioFifo.
+class AnalyserComponent : public juce::Component
+    ,   private juce::Timer
+{
+public:
+    explicit AnalyserComponent(AudioFifo& fifo);
+    ~AnalyserComponent() override;
+
+    void paint(juce::Graphics&) override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+    void pullSamples();
+    void computeSpectrum();
+
+    void drawScope(juce::Graphics& g, juce::Rectangle<float> area);
+    void drawSpectrum(juce::Graphics& g, juce::Rectangle<float> area);
+
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopeSize = 1024;
+
+    AudioFifo& audioFifo;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann };
+
+    std::vector<float> history;                     // Últimos fftSize samples (buffer circular)
+    int historyPos = 0;
+
+    std::vector<float> incoming;
+    std::vector<float> fftData;
+    std::vector<float> spectrumDb;                  // Magnitud suavizada en dB, fftSize / 2 bins
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyserComponent)
+};
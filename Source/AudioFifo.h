@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    AudioFifo.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// FIFO SPSC de samples para los analizadores del editor. El hilo de audio solo
+// copia samples (si no cabe el bloque entero se descarta lo que sobra) y el
+// hilo del UI los lee cuando le conviene. Ninguno de los dos bloquea ni reserva memoria.
+class AudioFifo
+{
+public:
+    // Hilo de audio
+    void push(const float* samples, int numSamples) noexcept
+    {
+        if (!active.load(std::memory_order_relaxed))
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            std::copy(samples, samples + size1, buffer.begin() + start1);
+        if (size2 > 0)
+            std::copy(samples + size1, samples + size1 + size2, buffer.begin() + start2);
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    // Hilo del UI. Devuelve el número de samples copiados en dest.
+    int pop(float* dest, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            std::copy(buffer.begin() + start1, buffer.begin() + start1 + size1, dest);
+        if (size2 > 0)
+            std::copy(buffer.begin() + start2, buffer.begin() + start2 + size2, dest + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+    // Mientras no haya ningún analizador visible el hilo de audio no copia nada
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+
+private:
+    static constexpr int capacity = 1 << 15;
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<float, capacity> buffer {};
+
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRate { 48000.0 };
+};
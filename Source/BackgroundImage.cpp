@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    BackgroundImage.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "BackgroundImage.h"
+#include "BinaryData.h"
+
+namespace
+{
+    // Imágenes ya escaladas. No dependen de las instancias de BackgroundImage: duran hasta que
+    // se cierra JUCE en el proceso (DeletedAtShutdown)
+    struct Decodificadas : private juce::DeletedAtShutdown
+    {
+        ~Decodificadas() override { clearSingletonInstance(); }
+
+        juce::CriticalSection lock;
+        juce::Image image1x;
+        juce::Image image2x;
+
+        JUCE_DECLARE_SINGLETON (Decodificadas, false)
+    };
+
+    JUCE_IMPLEMENT_SINGLETON (Decodificadas)
+
+    juce::int64 getBytes(const juce::Image& image)
+    {
+        if (!image.isValid())
+            return 0;
+
+        const juce::Image::BitmapData datos(image, juce::Image::BitmapData::readOnly);
+        return (juce::int64) datos.lineStride * datos.height;
+    }
+}
+
+BackgroundImage::BackgroundImage()
+    : Thread("Harpejji background decoder")
+{
+    auto* decodificadas = Decodificadas::getInstance();
+    const juce::ScopedLock sl(decodificadas->lock);
+
+    if (decodificadas->image1x.isValid())
+        ready.store(true, std::memory_order_release);
+    else
+        startThread(3);                                     // Prioridad baja: no debe competir con el audio
+}
+
+BackgroundImage::~BackgroundImage()
+{
+    stopThread(4000);
+}
+
+bool BackgroundImage::isReady() const noexcept
+{
+    return ready.load(std::memory_order_acquire);
+}
+
+juce::Image BackgroundImage::getImage(float physicalPixelScale) const
+{
+    auto* decodificadas = Decodificadas::getInstance();
+    const juce::ScopedLock sl(decodificadas->lock);
+    return physicalPixelScale > 1.0f && decodificadas->image2x.isValid() ? decodificadas->image2x : decodificadas->image1x;
+}
+
+juce::int64 BackgroundImage::getDecodedBytes()
+{
+    auto* decodificadas = Decodificadas::getInstance();
+    const juce::ScopedLock sl(decodificadas->lock);
+    return getBytes(decodificadas->image1x) + getBytes(decodificadas->image2x);
+}
+
+void BackgroundImage::run()
+{
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    // Los recursos ya vienen a la resolución en la que se dibujan (416 x 908 y
+    // 832 x 1816), así que no hace falta decodificar el original a 4x ni escalar.
+    auto scaled2x = juce::ImageFileFormat::loadFrom(BinaryData::Pluginbackground2x_jpg, (size_t) BinaryData::Pluginbackground2x_jpgSize);
+    if (threadShouldExit())
+        return;
+
+    auto scaled1x = juce::ImageFileFormat::loadFrom(BinaryData::Pluginbackground1x_jpg, (size_t) BinaryData::Pluginbackground1x_jpgSize);
+    if (!scaled1x.isValid() || threadShouldExit())
+        return;
+
+    {
+        auto* decodificadas = Decodificadas::getInstance();
+        const juce::ScopedLock sl(decodificadas->lock);
+        decodificadas->image1x = scaled1x;
+        decodificadas->image2x = scaled2x;
+    }
+
+    ready.store(true, std::memory_order_release);
+
+    DBG("Background decoded in " << juce::Time::getMillisecondCounterHiRes() - start << " ms");
+}
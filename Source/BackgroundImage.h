@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    BackgroundImage.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Imagen de fondo del editor compartida por todas las instancias del plugin.
+// Se usa a través de juce::SharedResourcePointer: la primera instancia que abre
+// el editor lanza la decodificación en un hilo propio y el resto reutiliza las
+// mismas imágenes ya escaladas a la resolución de pantalla (1x y 2x). Las
+// imágenes se conservan mientras viva el proceso, así que cerrar el último
+// editor y volver a abrirlo no repite la decodificación.
+class BackgroundImage : private juce::Thread
+{
+public:
+    BackgroundImage();
+    ~BackgroundImage() override;
+
+    bool isReady() const noexcept;
+    juce::Image getImage(float physicalPixelScale) const;
+
+    // Memoria de las imágenes decodificadas (0 hasta que termina la decodificación)
+    static juce::int64 getDecodedBytes();
+
+    static constexpr int width = 416;
+    static constexpr int height = 908;
+
+private:
+    void run() override;
+
+    std::atomic<bool> ready { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BackgroundImage)
+};
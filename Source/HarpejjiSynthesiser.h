@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    HarpejjiSynthesiser.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "NoteQueue.h"
+
+// Synthesiser que pasa a la voz la cuerda pedida por cada note on de la cola del
+// editor. Synthesiser entrega los eventos en orden y con su posición en el bloque
+// (el timestamp es el sample), justo antes de iniciar la voz: la cuerda se toma
+// del propio evento y no depende de lo que haga después la nota en el bloque.
+class HarpejjiSynthesiser : public juce::Synthesiser
+{
+public:
+    explicit HarpejjiSynthesiser(NoteQueue& queue) : notas(queue) {}
+
+    // Cuerda del note on que se está procesando (-1: la elige la voz). Para SynthVoice::setRequestedString
+    const int* getRequestedString() const noexcept { return &cuerdaPedida; }
+
+    void handleMidiEvent(const juce::MidiMessage& m) override
+    {
+        if (m.isNoteOn())
+            cuerdaPedida = notas.takeRequestedString(m.getNoteNumber(), (int) m.getTimeStamp());
+
+        juce::Synthesiser::handleMidiEvent(m);
+        cuerdaPedida = -1;
+    }
+
+private:
+    NoteQueue& notas;
+    int cuerdaPedida = -1;
+
+    JUCE_DECLARE_NON_COPYABLE (HarpejjiSynthesiser)
+};
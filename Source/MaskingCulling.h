@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    MaskingCulling.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Culling de voces por enmascaramiento: cuando suenan muchas cuerdas, las
+// colas de las más débiles quedan tapadas por las más fuertes y siguen
+// costando lo mismo. Cada voz se describe por su nivel a la salida del plugin
+// y por su fundamental e inarmonicidad; de ahí salen sus primeros parciales
+// (con amplitud 1/p, la de una cuerda pulsada). Un parcial de otra voz
+// enmascara al parcial de la candidata con su nivel menos un margen para
+// enmascaradores tonales y menos la función de dispersión en Bark (cae más
+// deprisa hacia los graves que hacia los agudos). La candidata se retira si
+// todos sus parciales quedan por debajo de ese umbral menos un margen que
+// fija la agresividad. Sin locks ni memoria: se llama desde el hilo de audio.
+class MaskingCulling
+{
+public:
+    static constexpr int maxVoces = 16;
+    static constexpr int numParciales = 4;          // Parciales de la candidata (y 2x de cada enmascarador)
+    static constexpr float edadMinima = 0.2f;       // s: el ataque de una nota no se enmascara
+
+    struct Voz
+    {
+        bool  activa = false;
+        float nivelDb = -200.0f;                    // Potencia media del último bloque a la salida del plugin
+        float frecuencia = 0.0f;                    // Fundamental (Hz), con bend
+        float inarmonicidad = 0.0f;                 // B: f_p = p f sqrt(1 + B p^2) / sqrt(1 + B)
+        float edad = 0.0f;                          // s desde el note on
+    };
+
+    // 0: desactivado. 1: se retira en cuanto una voz queda por debajo del umbral de enmascaramiento
+    void setAggressiveness(float nuevaAgresividad) noexcept
+    {
+        agresividad = juce::jlimit(0.0f, 1.0f, nuevaAgresividad);
+    }
+
+    float getAggressiveness() const noexcept { return agresividad; }
+    bool isEnabled() const noexcept { return agresividad > 0.0f; }
+
+    // Marca en 'retirar' las voces enmascaradas y devuelve cuántas son
+    int process(const Voz* voces, int numVoces, bool* retirar) const noexcept
+    {
+        numVoces = juce::jmin(numVoces, maxVoces);
+        int retiradas = 0;
+
+        for (int i = 0; i < numVoces; i++)
+            retirar[i] = false;
+
+        if (!isEnabled())
+            return 0;
+
+        const float margen = margenMaximoDb * (1.0f - agresividad);
+
+        // Posición en Bark de los parciales de cada voz, una vez por bloque
+        float z[maxVoces][2 * numParciales];
+        for (int j = 0; j < numVoces; j++)
+            for (int q = 1; q <= 2 * numParciales; q++)
+                z[j][q - 1] = voces[j].activa ? bark(frecuenciaParcial(voces[j], q)) : 0.0f;
+
+        for (int i = 0; i < numVoces; i++) {
+            const auto& candidata = voces[i];
+            if (!candidata.activa || candidata.edad < edadMinima)
+                continue;
+
+            bool enmascarada = true;
+
+            for (int p = 1; p <= numParciales && enmascarada; p++) {
+                const float nivelParcial = candidata.nivelDb - atenuacionParcialDb(p);
+                float umbral = -200.0f;
+
+                for (int j = 0; j < numVoces; j++) {
+                    const auto& masker = voces[j];
+
+                    // Solo enmascaran las voces más fuertes (una voz no se enmascara a sí misma)
+                    if (j == i || !masker.activa || masker.nivelDb <= candidata.nivelDb)
+                        continue;
+
+                    for (int q = 1; q <= 2 * numParciales; q++) {
+                        const float dz = z[i][p - 1] - z[j][q - 1];
+                        const float dispersion = dz >= 0.0f ? pendienteAgudosDb * dz : -pendienteGravesDb * dz;
+                        umbral = juce::jmax(umbral, masker.nivelDb - atenuacionParcialDb(q) - margenTonalDb - dispersion);
+                    }
+                }
+
+                enmascarada = nivelParcial < umbral - margen;
+            }
+
+            if (enmascarada) {
+                retirar[i] = true;
+                retiradas++;
+            }
+        }
+
+        return retiradas;
+    }
+
+    // Escala de Bark (Zwicker y Terhardt)
+    static float bark(float hz) noexcept
+    {
+        return 13.0f * std::atan(0.00076f * hz) + 3.5f * std::atan(juce::square(hz / 7500.0f));
+    }
+
+private:
+    static constexpr float margenTonalDb = 15.0f;       // Un tono enmascara peor que un ruido de la misma banda
+    static constexpr float pendienteGravesDb = 27.0f;   // dB/Bark por debajo del enmascarador
+    static constexpr float pendienteAgudosDb = 10.0f;   // dB/Bark por encima
+    static constexpr float margenMaximoDb = 20.0f;      // Margen con agresividad mínima
+
+    static float frecuenciaParcial(const Voz& v, int p) noexcept
+    {
+        return (float) p * v.frecuencia * std::sqrt((1.0f + v.inarmonicidad * (float) (p * p)) / (1.0f + v.inarmonicidad));
+    }
+
+    static float atenuacionParcialDb(int p) noexcept
+    {
+        return 20.0f * std::log10((float) p);
+    }
+
+    float agresividad = 0.0f;
+};
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    ModalComponent.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ModalComponent.h"
+
+namespace
+{
+    constexpr float rangoDb = 60.0f;                // Rango dibujado por debajo del modo más fuerte
+    constexpr float caida = 0.9f;                   // Caída de la envolvente por frame (la instantánea oscila con cada modo)
+}
+
+ModalComponent::ModalComponent(SynthAudioProcessor& p)
+    : fftData((size_t) (2 * fftSize), 0.0f), audioProcessor(p)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+ModalComponent::~ModalComponent()
+{
+}
+
+void ModalComponent::visibilityChanged()
+{
+    if (isVisible())
+        startTimerHz(30);
+    else
+        stopTimer();
+}
+
+void ModalComponent::computeModes(const std::vector<float>& shape, std::array<float, numModes>& out)
+{
+    out.fill(0.0f);
+
+    const int X = (int) shape.size() - 1;          // Extremos fijos en 0 y X
+    if (X < 2)
+        return;
+
+    // Se remuestrea la cuerda a M intervalos para poder usar una FFT de tamaño
+    // potencia de 2 y se construye la extensión impar: z[2M - j] = -z[j]
+    std::fill(fftData.begin(), fftData.end(), 0.0f);
+
+    for (int j = 1; j < M; j++) {
+        const float pos = (float) j * (float) X / (float) M;
+        const int i0 = (int) pos;
+        const float frac = pos - (float) i0;
+        const float y = shape[(size_t) i0] + frac * (shape[(size_t) juce::jmin(i0 + 1, X)] - shape[(size_t) i0]);
+
+        fftData[(size_t) j] = y;
+        fftData[(size_t) (fftSize - j)] = -y;
+    }
+
+    fft.performRealOnlyForwardTransform(fftData.data(), true);
+
+    // Z[n] = -2i * sum(y[j] * sin(pi n j / M))  ->  b_n = -Im(Z[n]) / M
+    for (int n = 1; n <= numModes && n < M; n++)
+        out[(size_t) (n - 1)] = std::abs(fftData[(size_t) (2 * n + 1)]) / (float) M;
+}
+
+void ModalComponent::timerCallback()
+{
+    const auto numCuerda = audioProcessor.getNumCuerda();
+    const auto numTraste = audioProcessor.getNumTraste();
+    const auto visualCuerda = audioProcessor.getVisual();
+
+    for (auto& c : cuerdas)
+        c.activa = false;
+
+    if (numCuerda.size() == numTraste.size() && numCuerda.size() == visualCuerda.size()) {
+        for (size_t v = 0; v < numCuerda.size(); v++) {
+            if (numCuerda[v] < 0 || numCuerda[v] >= (int) cuerdas.size())
+                continue;
+
+            auto& c = cuerdas[(size_t) numCuerda[v]];
+
+            if (c.traste != numTraste[v]) {         // Nota nueva en esta cuerda
+                c.traste = numTraste[v];
+                c.envolvente.fill(0.0f);
+                c.maximo.fill(0.0f);
+            }
+
+            computeModes(visualCuerda[v], modes);
+
+            for (int n = 0; n < numModes; n++) {
+                c.envolvente[(size_t) n] = juce::jmax(modes[(size_t) n], c.envolvente[(size_t) n] * caida);
+                c.maximo[(size_t) n] = juce::jmax(c.maximo[(size_t) n], c.envolvente[(size_t) n]);
+            }
+
+            c.activa = true;
+        }
+    }
+
+    for (auto& c : cuerdas)
+        if (!c.activa)
+            c.traste = -1;
+
+    repaint();
+}
+
+void ModalComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(0.75f));
+
+    int numActivas = 0;
+    for (auto& c : cuerdas)
+        numActivas += c.activa ? 1 : 0;
+
+    if (numActivas == 0)
+        return;
+
+    auto area = getLocalBounds().toFloat().reduced(4.0f);
+    const float altoFila = area.getHeight() / (float) numActivas;
+
+    for (int i = 0; i < (int) cuerdas.size(); i++) {
+        const auto& c = cuerdas[(size_t) i];
+        if (!c.activa)
+            continue;
+
+        auto fila = area.removeFromTop(altoFila).reduced(0.0f, 2.0f);
+
+        g.setColour(juce::Colours::lightgrey);
+        g.setFont(juce::jmin(12.0f, fila.getHeight()));
+        g.drawText(juce::String(i + 1) + "/" + juce::String(c.traste), fila.removeFromLeft(36.0f), juce::Justification::centredLeft);
+
+        const float ref = *std::max_element(c.maximo.begin(), c.maximo.end());
+        if (ref <= 0.0f)
+            continue;
+
+        const float anchoModo = fila.getWidth() / (float) numModes;
+
+        auto alto = [&](float amplitud) {
+            const float db = juce::Decibels::gainToDecibels(amplitud / ref, -rangoDb);
+            return fila.getHeight() * (db + rangoDb) / rangoDb;
+        };
+
+        for (int n = 0; n < numModes; n++) {
+            const float x = fila.getX() + n * anchoModo;
+
+            g.setColour(juce::Colours::orange);
+            const float h = alto(c.envolvente[(size_t) n]);
+            g.fillRect(x + 1.0f, fila.getBottom() - h, anchoModo - 2.0f, h);
+
+            g.setColour(juce::Colours::white.withAlpha(0.6f));
+            g.drawHorizontalLine((int) (fila.getBottom() - alto(c.maximo[(size_t) n])), x + 1.0f, x + anchoModo - 1.0f);
+        }
+    }
+}
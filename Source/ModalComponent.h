@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    ModalComponent.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Contenido modal de cada cuerda activa. A partir de las mismas instantáneas
+// de la cuerda que dibuja el editor se calcula la transformada seno (DST-I)
+// con una FFT de la extensión impar de la forma de la cuerda. Cada modo se
+// dibuja con su amplitud actual y la máxima desde que empezó la nota, así se
+// ve qué armónicos refuerzan ctr/read y cómo se van apagando.
+class ModalComponent : public juce::Component
+    ,   private juce::Timer
+{
+public:
+    explicit ModalComponent(SynthAudioProcessor& p);
+    ~ModalComponent() override;
+
+    void paint(juce::Graphics&) override;
+    void visibilityChanged() override;
+
+    static constexpr int numModes = 16;
+
+private:
+    void timerCallback() override;
+    void computeModes(const std::vector<float>& shape, std::array<float, numModes>& modes);
+
+    static constexpr int fftOrder = 9;
+    static constexpr int fftSize = 1 << fftOrder;   // Extensión impar: 2 * M
+    static constexpr int M = fftSize / 2;           // Puntos de la cuerda remuestreada
+
+    struct EstadoCuerda
+    {
+        bool activa = false;
+        int traste = -1;
+        std::array<float, numModes> envolvente {};  // Amplitud actual (envolvente de pico)
+        std::array<float, numModes> maximo {};      // Amplitud máxima desde el inicio de la nota
+    };
+
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> fftData;
+    std::array<float, numModes> modes {};
+    std::array<EstadoCuerda, 16> cuerdas;
+
+    SynthAudioProcessor& audioProcessor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModalComponent)
+};
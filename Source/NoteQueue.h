@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    NoteQueue.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Cola SPSC sin bloqueos para pasar notas del editor (productor) al hilo de
+// audio (consumidor). El productor nunca espera: si la cola está llena la nota
+// se descarta. El consumidor no reserva memoria ni toma locks. Cada nota lleva
+// la cuerda pulsada: una misma nota está en varias cuerdas y la voz no debe
+// elegir otra. La cuerda viaja con el evento (no con la nota) y solo se aplica
+// a los note on que salen de la cola, nunca al MIDI del host.
+class NoteQueue
+{
+public:
+    struct Event
+    {
+        int         note;
+        float       velocity;                       // 0 -> note off
+        int         cuerda;                         // -1: la elige la voz
+        juce::int64 ticks;                          // Instante en que se pulsó (Time::getHighResolutionTicks)
+    };
+
+    // Hilo del UI
+    bool push(int note, float velocity, int cuerda = -1) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        events[(size_t)(size1 > 0 ? start1 : start2)] = { note, velocity, cuerda, juce::Time::getHighResolutionTicks() };
+        fifo.finishedWrite(1);
+        return true;
+    }
+
+    // Hilo de audio. Cada evento se coloca exactamente un bloque después de su
+    // pulsación: así se conserva el ritmo entre pulsaciones (precisión de sample)
+    // y la latencia queda acotada por la duración de un bloque.
+    void mergeInto(juce::MidiBuffer& midi, int numSamples, double sampleRate, juce::int64 blockStartTicks) noexcept
+    {
+        numPedidas = 0;
+
+        const int numReady = fifo.getNumReady();
+        if (numReady == 0 || numSamples <= 0)
+            return;
+
+        const double ticksPerSample = (double) juce::Time::getHighResolutionTicksPerSecond() / sampleRate;
+        const juce::int64 blockTicks = (juce::int64) (numSamples * ticksPerSample);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        auto mergeRange = [&](int start, int size)
+        {
+            for (int i = start; i < start + size; i++) {
+                const auto& e = events[(size_t)i];
+
+                int offset = (int) ((double) (e.ticks + blockTicks - blockStartTicks) / ticksPerSample);
+                offset = juce::jlimit(0, numSamples - 1, offset);
+
+                if (e.velocity > 0.0f) {
+                    if (e.cuerda >= 0) {
+                        const int anteriores = contarNoteOns(midi, offset, e.note);
+                        pedidas[(size_t) numPedidas++] = { offset, e.note, e.cuerda, anteriores, false };
+                    }
+
+                    midi.addEvent(juce::MidiMessage::noteOn(1, e.note, e.velocity), offset);
+                }
+                else
+                    midi.addEvent(juce::MidiMessage::noteOff(1, e.note), offset);
+
+                const float latency = (float) (1000.0 * ((double) (blockStartTicks - e.ticks) / ticksPerSample + offset) / sampleRate);
+                lastLatencyMs.store(latency, std::memory_order_relaxed);
+                if (latency > maxLatencyMs.load(std::memory_order_relaxed))
+                    maxLatencyMs.store(latency, std::memory_order_relaxed);
+            }
+        };
+
+        mergeRange(start1, size1);
+        mergeRange(start2, size2);
+        fifo.finishedRead(size1 + size2);
+    }
+
+    // Latencia entre la pulsación y el primer sample de la nota (ms)
+    float getLastLatencyMs() const noexcept { return lastLatencyMs.load(std::memory_order_relaxed); }
+    float getMaxLatencyMs() const noexcept  { return maxLatencyMs.load(std::memory_order_relaxed); }
+
+    // Hilo de audio, durante el render del bloque mezclado por el último mergeInto. Cuerda pedida
+    // para el note on de la nota en la posición offset del bloque (-1: la elige la voz). Hay que
+    // llamarla una vez por cada note on, en el orden del buffer: los del host que coinciden en
+    // posición y nota con uno de la cola van antes que él y no se llevan su cuerda.
+    int takeRequestedString(int note, int offset) noexcept
+    {
+        Pedida* primera = nullptr;
+
+        for (int i = 0; i < numPedidas && primera == nullptr; i++) {
+            auto& p = pedidas[(size_t) i];
+            if (!p.usada && p.note == note && p.offset == offset)
+                primera = &p;
+        }
+
+        if (primera == nullptr)
+            return -1;
+
+        if (primera->anteriores == 0) {
+            primera->usada = true;
+            return primera->cuerda;
+        }
+
+        // Es uno de los note on que estaban antes en el buffer (host o cola sin cuerda)
+        for (int i = 0; i < numPedidas; i++) {
+            auto& p = pedidas[(size_t) i];
+            if (!p.usada && p.note == note && p.offset == offset)
+                p.anteriores--;
+        }
+
+        return -1;
+    }
+
+private:
+    static constexpr int capacity = 256;
+
+    // Note on de la cola con cuerda en el bloque actual
+    struct Pedida
+    {
+        int  offset;
+        int  note;
+        int  cuerda;
+        int  anteriores;                            // Note on sin cuerda pedida que van antes en la misma posición
+        bool usada;
+    };
+
+    // Note on de la nota en la posición offset que ya están en el buffer y no son de la tabla
+    int contarNoteOns(const juce::MidiBuffer& midi, int offset, int note) const noexcept
+    {
+        int n = 0;
+        for (auto it = midi.findNextSamplePosition(offset); it != midi.cend() && (*it).samplePosition == offset; ++it) {
+            const auto m = *it;
+            if (m.numBytes == 3 && (m.data[0] & 0xf0) == 0x90 && m.data[1] == note && m.data[2] > 0)
+                n++;
+        }
+
+        for (int i = 0; i < numPedidas; i++)
+            if (pedidas[(size_t) i].offset == offset && pedidas[(size_t) i].note == note)
+                n--;
+
+        return n;
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<Event, capacity> events {};
+    std::array<Pedida, capacity> pedidas {};
+    int numPedidas = 0;
+
+    std::atomic<float> lastLatencyMs { 0.0f };
+    std::atomic<float> maxLatencyMs { 0.0f };
+};
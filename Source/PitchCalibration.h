@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PitchCalibration.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PitchCalibrationTables.h"
+
+// Tabla de corrección de afinación: cents que hay que sumar a la frecuencia de
+// una nota para que la fundamental simulada (con la dispersión numérica de la
+// malla) caiga en la frecuencia de la nota. Una entrada por nota MIDI del
+// instrumento y por tensión; entre entradas se interpola linealmente.
+// La rellena SynthVoice::calibratePitch midiendo la cuerda simulada, o
+// setPrecomputed a partir de las tablas ya medidas (PitchCalibrationTables.h).
+class PitchCalibration
+{
+public:
+    static constexpr int firstNote = 36;            // 65.4 Hz
+    static constexpr int numNotes = 49;             // Hasta la 84 (1046.5 Hz)
+    static constexpr int numTensions = 8;
+    static constexpr float minTension = 0.1f;       // Rango del parámetro TENSION
+    static constexpr float maxTension = 1.4f;
+
+    static float getTension(int index) noexcept
+    {
+        return minTension + (maxTension - minTension) * (float) index / (float) (numTensions - 1);
+    }
+
+    void clear() noexcept
+    {
+        cents.fill(0.0f);
+    }
+
+    void addCents(int note, int tensionIndex, float correction) noexcept
+    {
+        cents[(size_t) getIndex(note - firstNote, tensionIndex)] += correction;
+    }
+
+    float getCents(int note, int tensionIndex) const noexcept
+    {
+        return cents[(size_t) getIndex(note - firstNote, tensionIndex)];
+    }
+
+    // Tabla de la malla por defecto a partir de las precalculadas: interpola linealmente entre las
+    // dos frecuencias de muestreo más próximas (fuera del rango se usa la del extremo)
+    void setPrecomputed(double sampleRate) noexcept
+    {
+        using namespace pitchCalibrationTables;
+        static_assert(numNotes == PitchCalibration::numNotes && numTensions == PitchCalibration::numTensions,
+                      "PitchCalibrationTables.h no corresponde a PitchCalibration: regenerar con harpejji_tests --update-calibration");
+
+        int i1 = 0;
+        while (i1 < numSampleRates - 1 && sampleRates[i1] < sampleRate)
+            i1++;
+
+        const int i0 = juce::jmax(0, i1 - 1);
+        const float peso = sampleRates[i1] > sampleRates[i0]
+                         ? (float) juce::jlimit(0.0, 1.0, (sampleRate - sampleRates[i0]) / (sampleRates[i1] - sampleRates[i0]))
+                         : 1.0f;
+
+        for (int n = 0; n < numNotes; n++)
+            for (int t = 0; t < numTensions; t++)
+                cents[(size_t) getIndex(n, t)] = pitchCalibrationTables::cents[i0][n][t] * (1.0f - peso)
+                                                + pitchCalibrationTables::cents[i1][n][t] * peso;
+    }
+
+    // Corrección para una nota (fraccionaria) y una tensión cualesquiera
+    float getCorrectionCents(float note, float tension) const noexcept
+    {
+        const float n = juce::jlimit(0.0f, (float) (numNotes - 1), note - (float) firstNote);
+        const float t = juce::jlimit(0.0f, (float) (numTensions - 1),
+                                     (tension - minTension) * (float) (numTensions - 1) / (maxTension - minTension));
+
+        const int n0 = juce::jmin((int) n, numNotes - 2);
+        const int t0 = juce::jmin((int) t, numTensions - 2);
+        const float fn = n - (float) n0;
+        const float ft = t - (float) t0;
+
+        const float abajo  = cents[(size_t) getIndex(n0, t0)]     * (1.0f - fn) + cents[(size_t) getIndex(n0 + 1, t0)]     * fn;
+        const float arriba = cents[(size_t) getIndex(n0, t0 + 1)] * (1.0f - fn) + cents[(size_t) getIndex(n0 + 1, t0 + 1)] * fn;
+        return abajo * (1.0f - ft) + arriba * ft;
+    }
+
+private:
+    static int getIndex(int noteIndex, int tensionIndex) noexcept
+    {
+        return juce::jlimit(0, numNotes - 1, noteIndex) * numTensions + juce::jlimit(0, numTensions - 1, tensionIndex);
+    }
+
+    std::array<float, numNotes * numTensions> cents {};
+};
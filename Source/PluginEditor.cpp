@@ -3,8 +3,13 @@
 #include "PluginEditor.h"
 
 //==============================================================================
+juce::AudioProcessorEditor* SynthAudioProcessorEditor::create (SynthAudioProcessor& p)
+{
+    return new SynthAudioProcessorEditor (p);
+}
+
 SynthAudioProcessorEditor::SynthAudioProcessorEditor (SynthAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), analyser (p.getAnalyserFifo()), modal (p), statsOverlay (p.getStats()), audioProcessor (p)
 {
     setSize (416, 908);
 
@@ -21,6 +26,24 @@ SynthAudioProcessorEditor::SynthAudioProcessorEditor (SynthAudioProcessor& p)
     setSliderParams(gainSlider, gainLabel, "Gain");
     setSliderParams(sustainSlider, sustainLabel, "Sustain");
 
+    // Panel de análisis (osciloscopio + espectro) sobre el diapasón
+    analyserButton.setClickingTogglesState(true);
+    analyserButton.onClick = [this] { analyser.setVisible(analyserButton.getToggleState()); };
+    addAndMakeVisible(analyserButton);
+    addChildComponent(analyser);
+
+    // Contenido modal de las cuerdas (DST de la forma de cada cuerda)
+    modalButton.setClickingTogglesState(true);
+    modalButton.onClick = [this] { modal.setVisible(modalButton.getToggleState()); };
+    addAndMakeVisible(modalButton);
+    addChildComponent(modal);
+
+    // Estadísticas de rendimiento del procesador (tiempo por bloque, voces, notas)
+    statsButton.setClickingTogglesState(true);
+    statsButton.onClick = [this] { statsOverlay.setVisible(statsButton.getToggleState()); };
+    addAndMakeVisible(statsButton);
+    addChildComponent(statsOverlay);
+
     Timer::startTimerHz(60);
 }
 
@@ -31,11 +54,11 @@ SynthAudioProcessorEditor::~SynthAudioProcessorEditor()
 //==============================================================================
 void SynthAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    g.fillAll(juce::Colours::transparentBlack);
-    
-    Image background = ImageCache::getFromMemory(BinaryData::Pluginbackground_jpg, BinaryData::Pluginbackground_jpgSize);
-    background = background.rescaled(416, 908, Graphics::mediumResamplingQuality);
-    g.drawImageAt(background, 0, 0);
+    // Hasta que el hilo de decodificación termina se dibuja un fondo liso
+    if (background->isReady())
+        g.drawImage(background->getImage(g.getInternalContext().getPhysicalPixelScaleFactor()), getLocalBounds().toFloat());
+    else
+        g.fillAll(juce::Colours::black);
 
     numTraste = audioProcessor.getNumTraste();
     numCuerda = audioProcessor.getNumCuerda();
@@ -113,6 +136,15 @@ void SynthAudioProcessorEditor::resized()
     sustainSlider.setBounds(sliderStartX + bounds.getWidth() / 4, sliderStartY, sliderWidth, sliderHeight);
     toneSlider.setBounds(sliderStartX + 2 * bounds.getWidth() / 4, sliderStartY, sliderWidth, sliderHeight);
     gainSlider.setBounds(sliderStartX + 3 * bounds.getWidth() / 4, sliderStartY, sliderWidth, sliderHeight);
+
+    analyserButton.setBounds(bounds.getWidth() - 40, 94, 36, 14);
+    analyser.setBounds(0, 110, bounds.getWidth(), 320);
+
+    modalButton.setBounds(bounds.getWidth() - 84, 94, 42, 14);
+    modal.setBounds(0, 434, bounds.getWidth(), 240);
+
+    statsButton.setBounds(bounds.getWidth() - 126, 94, 40, 14);
+    statsOverlay.setBounds(0, bounds.getHeight() - 130, bounds.getWidth(), 130);
 }
 
 void SynthAudioProcessorEditor::setSliderParams(juce::Slider& slider, juce::Label& label, juce::String name) {
@@ -130,4 +162,70 @@ void SynthAudioProcessorEditor::setSliderParams(juce::Slider& slider, juce::Labe
 void SynthAudioProcessorEditor::timerCallback()
 {
     repaint();
+}
+
+//==============================================================================
+// Diapasón interactivo: cada dedo (o el ratón) toca la cuerda/traste que pulsa
+
+SynthAudioProcessorEditor::Pulsacion SynthAudioProcessorEditor::getFretAt(juce::Point<float> position) const
+{
+    const float altoPanel = 110.0f;                 // Zona de los controles
+    const float altoCuerda = 908.0f;
+    const float r = 1.0f - 1.0f / 17.817f;          // Misma relación entre trastes que en paint()
+
+    if (position.y < altoPanel || position.y > altoCuerda || position.x < 0 || position.x >= getWidth())
+        return {};
+
+    // Las cuerdas están separadas un tono empezando en C2 (MIDI 36) y el traste 1 es la cuerda al aire
+    Pulsacion p;
+    p.cuerda = juce::jlimit(0, 15, (int) (position.x * 16.0f / getWidth()));
+    p.traste = 1 + (int) std::floor(std::log(position.y / altoCuerda) / std::log(r));
+    p.nota = 36 + 2 * p.cuerda + p.traste - 1;
+
+    if (p.nota > 84)                                // 84 -> 1046.5 Hz, la nota más aguda que acepta SynthVoice
+        p.nota = -1;
+
+    return p;
+}
+
+void SynthAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+    const int dedo = e.source.getIndex();
+    if (dedo < 0 || dedo >= (int) pulsada.size())
+        return;
+
+    // La voz suena en la cuerda pulsada (la misma nota está en varias cuerdas)
+    const auto p = getFretAt(e.position);
+    if (p.nota >= 0)
+        audioProcessor.postNoteOn(p.nota, e.isPressureValid() ? e.pressure : 0.8f, p.cuerda);
+
+    pulsada[(size_t) dedo] = p;
+}
+
+void SynthAudioProcessorEditor::mouseDrag(const juce::MouseEvent& e)
+{
+    const int dedo = e.source.getIndex();
+    if (dedo < 0 || dedo >= (int) pulsada.size())
+        return;
+
+    // Al deslizar a otra cuerda o traste se suelta la nota anterior y se toca la nueva
+    const auto p = getFretAt(e.position);
+    const auto& anterior = pulsada[(size_t) dedo];
+    if (p.nota == anterior.nota && p.cuerda == anterior.cuerda)
+        return;
+
+    mouseUp(e);
+    mouseDown(e);
+}
+
+void SynthAudioProcessorEditor::mouseUp(const juce::MouseEvent& e)
+{
+    const int dedo = e.source.getIndex();
+    if (dedo < 0 || dedo >= (int) pulsada.size())
+        return;
+
+    if (pulsada[(size_t) dedo].nota >= 0)
+        audioProcessor.postNoteOff(pulsada[(size_t) dedo].nota);
+
+    pulsada[(size_t) dedo] = {};
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "BackgroundImage.h"
+#include "AnalyserComponent.h"
+#include "ModalComponent.h"
+#include "StatsComponent.h"
 
 //==============================================================================
 class SynthAudioProcessorEditor  : public juce::AudioProcessorEditor
@@ -11,12 +15,28 @@ public:
     SynthAudioProcessorEditor (SynthAudioProcessor&);
     ~SynthAudioProcessorEditor() override;
 
+    // Para SynthAudioProcessor::setEditorFactory
+    static juce::AudioProcessorEditor* create (SynthAudioProcessor&);
+
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
 
     void timerCallback() override;
 
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+
+    // Cuerda, traste y nota MIDI del diapasón en una posición del editor (nota -1 si no hay ninguna)
+    struct Pulsacion
+    {
+        int cuerda = -1;
+        int traste = -1;
+        int nota = -1;
+    };
+    Pulsacion getFretAt(juce::Point<float> position) const;
+
 private:
     void setSliderParams(juce::Slider& slider, juce::Label& label, juce::String name);
 
@@ -30,6 +50,15 @@ private:
     juce::Label gainLabel;
     juce::Label sustainLabel;
 
+    juce::TextButton analyserButton { "FFT" };
+    AnalyserComponent analyser;
+
+    juce::TextButton modalButton { "Modos" };
+    ModalComponent modal;
+
+    juce::TextButton statsButton { "Stats" };
+    StatsComponent statsOverlay;
+
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
 
     std::unique_ptr<SliderAttachment> tensionAttachment;
@@ -39,9 +68,13 @@ private:
 
     ScopedPointer<Graphics> cuerdaGraphic;
 
+    juce::SharedResourcePointer<BackgroundImage> background;
+
     std::vector <int> numTraste;
     std::vector <int> numCuerda;
     std::vector <std::vector <float>> visualCuerda;
+
+    std::array<Pulsacion, 10> pulsada;              // Lo que toca cada dedo/ratón (nota -1 si nada)
     
     SynthAudioProcessor& audioProcessor;
 
@@ -0,0 +1,22 @@
+/*
+  ==============================================================================
+
+    PluginEntry.cpp
+    Created: 19 Oct 2026
+
+    Punto de entrada del plugin. El procesador está en harpejji_core, que no
+    incluye el editor: se registra aquí, al crear cada instancia.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    SynthAudioProcessor::setEditorFactory (&SynthAudioProcessorEditor::create);
+    return new SynthAudioProcessor();
+}
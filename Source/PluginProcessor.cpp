@@ -7,7 +7,53 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+
+namespace
+{
+    std::atomic<SynthAudioProcessor::EditorFactory> editorFactory { nullptr };
+
+    // Standalone con HARPEJJI_STATS=<segundos>: resumen periódico de ProcessorStats en la consola
+    class StatsLogger : public juce::Timer
+    {
+    public:
+        StatsLogger(const ProcessorStats& s, int periodoSegundos) : stats(s)
+        {
+            anterior = stats.getSnapshot();
+            startTimer(1000 * juce::jmax(1, periodoSegundos));
+        }
+
+        void timerCallback() override
+        {
+            const auto actual = stats.getSnapshot();
+            std::cout << "[stats] " << actual.since(anterior).describe().joinIntoString(" | ") << std::endl;
+            anterior = actual;
+        }
+
+    private:
+        const ProcessorStats& stats;
+        ProcessorStats::Snapshot anterior;
+    };
+
+    // La calibración de afinación solo depende de la frecuencia de muestreo (el procesador usa los
+    // ajustes por defecto de la malla). No se mide en prepareToPlay: sale de las tablas precalculadas
+    // (PitchCalibrationTables.h), interpoladas si la frecuencia no es una de ellas. Cada tabla se
+    // construye una vez por proceso y la comparten todas las instancias
+    const PitchCalibration& getPitchCalibration(double sampleRate)
+    {
+        static juce::CriticalSection lock;
+        static std::map<double, std::unique_ptr<PitchCalibration>> tablas;
+
+        const juce::ScopedLock sl(lock);
+        auto& tabla = tablas[sampleRate];
+
+        if (tabla == nullptr) {
+            tabla = std::make_unique<PitchCalibration>();
+            tabla->setPrecomputed(sampleRate);
+        }
+
+        return *tabla;
+    }
+}
 
 //==============================================================================
 SynthAudioProcessor::SynthAudioProcessor()
@@ -25,12 +71,39 @@ SynthAudioProcessor::SynthAudioProcessor()
 {
     synth.addSound(new SynthSound());
     for (int i = 0; i < numVoices; i++) {
-        synth.addVoice(new SynthVoice());
+        auto* voice = new SynthVoice();
+        voice->setRequestedString(synth.getRequestedString());
+        synth.addVoice(voice);
+    }
+
+    tensionParam = apvts.getRawParameterValue("TENSION");
+    sustainParam = apvts.getRawParameterValue("SUSTAIN");
+    toneParam    = apvts.getRawParameterValue("TONE");
+    gainParam    = apvts.getRawParameterValue("GAIN");
+
+    const auto periodoStats = juce::SystemStats::getEnvironmentVariable("HARPEJJI_STATS", {});
+    if (wrapperType == wrapperType_Standalone && periodoStats.isNotEmpty())
+        statsLogger = std::make_unique<StatsLogger>(stats, periodoStats.getIntValue());
+
+    const auto ficheroTraza = juce::SystemStats::getEnvironmentVariable("HARPEJJI_TRACE", {});
+    if (ficheroTraza.isNotEmpty())
+        traceIniciada = trace::start(juce::File::getCurrentWorkingDirectory().getChildFile(ficheroTraza));
+
+    const auto nombreShm = juce::SystemStats::getEnvironmentVariable("HARPEJJI_SHM", {});
+    if (nombreShm.isNotEmpty()) {
+        sharedMetrics = SharedMetrics::create(nombreShm);
+
+        if (sharedMetrics == nullptr)
+            DBG("No se pudo crear la memoria compartida " << nombreShm);
+        else if (sharedMetrics->getName().trimCharactersAtStart("/") != nombreShm.trimCharactersAtStart("/"))
+            std::cout << "[shm] " << nombreShm << " ya está en uso; métricas en " << sharedMetrics->getName() << std::endl;
     }
 }
 
 SynthAudioProcessor::~SynthAudioProcessor()
 {
+    if (traceIniciada)
+        trace::stop();
 }
 
 //==============================================================================
@@ -111,11 +184,39 @@ void SynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     gain.prepare(spec);
     gain.reset();
 
+    mergedMidi.ensureSize(4096);
+
+    analyserFifo.setSampleRate(sampleRate);
+    stats.setSampleRate(sampleRate);
+
     for (int i = 0; i < synth.getNumVoices(); ++i) {
         if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i))) {
             voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
         }
     }
+
+    const auto& calibracion = getPitchCalibration(sampleRate);
+
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+        if (auto v = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+            v->setPitchCalibration(&calibracion);
+
+    // Se reserva la memoria del estado visual para que processBlock no tenga que hacerlo
+    const juce::SpinLock::ScopedLockType lock(visualLock);
+    numCuerda.clear();
+    numTraste.clear();
+    numCuerda.reserve(numVoices);
+    numTraste.reserve(numVoices);
+    visualCuerda.resize(numVoices);
+
+    for (int i = 0; i < synth.getNumVoices(); ++i) {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+            visualCuerda[i].reserve(voice->getMaxPuntos() + 1);
+    }
+    numVisual = 0;
+
+    lastCutOff = -1.0f;
+    updateParams();
 }
 
 void SynthAudioProcessor::releaseResources()
@@ -145,6 +246,10 @@ bool SynthAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 
 void SynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const rtcheck::ScopedAudioThread audioThread;
+    HARPEJJI_TRACE_SCOPE("processBlock", buffer.getNumSamples());
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+
     dsp::AudioBlock<float> block(buffer);
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -153,58 +258,144 @@ void SynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    visualCuerda.clear();
-    numCuerda.clear();
-    numTraste.clear();
+    {
+        // Si el editor está copiando el estado de las cuerdas se salta la copia de este bloque
+        const juce::SpinLock::ScopedTryLockType visualTryLock(visualLock);
+        const bool updateVisual = visualTryLock.isLocked() && (int)visualCuerda.size() >= synth.getNumVoices();
 
-    for (int i = 0; i < synth.getNumVoices(); ++i) {
-        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
-        {
-            // Aquí se actualizan los parámetros para cada voz
-            auto& tension = *apvts.getRawParameterValue("TENSION");
-            auto& sustain = *apvts.getRawParameterValue("SUSTAIN");
+        if (updateVisual) {
+            numCuerda.clear();
+            numTraste.clear();
+            numVisual = 0;
+        }
 
-            voice->updateParams(tension, sustain);
+        const float gananciaSalida = juce::Decibels::decibelsToGain(gainParam->load());
 
-            if (voice->isVoiceActive())
+        for (int i = 0; i < synth.getNumVoices(); ++i) {
+            if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
             {
-                visualCuerda.push_back(voice->getVisual());
-                numCuerda.push_back(voice->getNumCuerda());
-                numTraste.push_back(voice->getNumTraste());
+                // Aquí se actualizan los parámetros para cada voz
+                voice->updateParams(tensionParam->load(), sustainParam->load());
+                voice->setOutputStage(gananciaSalida, toneParam->load(), silenceFloorDb.load(std::memory_order_relaxed));
+
+                if (updateVisual && voice->isVoiceActive())
+                {
+                    voice->copyVisual(visualCuerda[numVisual++]);
+                    numCuerda.push_back(voice->getNumCuerda());
+                    numTraste.push_back(voice->getNumTraste());
+                }
             }
         }
     }
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
-    updateParams();
-    lpf.process(dsp::ProcessContextReplacing<float>(block));
-    gain.process(dsp::ProcessContextReplacing<float>(block));
+
+    // Se mezclan las notas del editor con el MIDI del host
+    mergedMidi.clear();
+    mergedMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
+    uiNotes.mergeInto(mergedMidi, buffer.getNumSamples(), getSampleRate(), blockStartTicks);
+
+    synth.renderNextBlock(buffer, mergedMidi, 0, buffer.getNumSamples());
+
+    // Culling por enmascaramiento: las voces tapadas por otras más fuertes se funden en el bloque siguiente
+    culling.setAggressiveness(maskingAggressiveness.load(std::memory_order_relaxed));
+
+    if (culling.isEnabled()) {
+        std::array<MaskingCulling::Voz, MaskingCulling::maxVoces> voces {};
+        std::array<bool, MaskingCulling::maxVoces> retirar {};
+        const int numVoces = juce::jmin(synth.getNumVoices(), MaskingCulling::maxVoces);
+
+        for (int i = 0; i < numVoces; ++i)
+            if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+                if (voice->isVoiceActive())
+                    voces[(size_t) i] = { true, voice->getOutputLevelDb(), voice->getFundamental(), voice->getInharmonicity(), voice->getNoteAge() };
+
+        if (culling.process(voces.data(), numVoces, retirar.data()) > 0)
+            for (int i = 0; i < numVoces; ++i)
+                if (retirar[(size_t) i])
+                    if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+                        voice->retire();
+    }
+
+    {
+        HARPEJJI_TRACE_SCOPE("filtro");
+        updateParams();
+        lpf.process(dsp::ProcessContextReplacing<float>(block));
+        gain.process(dsp::ProcessContextReplacing<float>(block));
+    }
+
+    analyserFifo.push(buffer.getReadPointer(0), buffer.getNumSamples());
+
+    // Estadísticas del bloque
+    int noteOns = 0;
+    for (const auto metadata : mergedMidi)
+        if (metadata.numBytes == 3 && (metadata.data[0] & 0xf0) == 0x90 && metadata.data[2] > 0)
+            noteOns++;
+
+    int activeVoices = 0, iniciadas = 0, silenciadas = 0, inestables = 0, enmascaradas = 0;
+    juce::int64 puntos = 0;
+
+    for (int i = 0; i < synth.getNumVoices(); ++i) {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i))) {
+            const auto voiceStats = voice->takeBlockStats();
+            iniciadas += voiceStats.notasIniciadas;
+            silenciadas += voiceStats.notasSilenciadas;
+            inestables += voiceStats.notasInestables;
+            enmascaradas += voiceStats.notasEnmascaradas;
+            puntos += voiceStats.puntos;
+
+            if (voice->isVoiceActive())
+                activeVoices++;
+        }
+    }
+
+    const float blockUs = (float) (1.0e6 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks));
+    const int perdidas = juce::jmax(0, noteOns - iniciadas);
+    stats.addBlock(blockUs, buffer.getNumSamples(), activeVoices, puntos, noteOns, silenciadas, perdidas, inestables, enmascaradas);
+
+    if (sharedMetrics != nullptr && buffer.getNumSamples() > 0) {
+        const float load = blockUs * (float) getSampleRate() / (1.0e6f * (float) buffer.getNumSamples());
+
+        metricas.numBlocks++;
+        metricas.xruns += load > 1.0f ? 1 : 0;
+        metricas.voicesSilenced += (juce::uint64) silenciadas;
+        metricas.droppedNotes += (juce::uint64) perdidas;
+        metricas.voicesQuarantined += (juce::uint64) inestables;
+        metricas.voicesMasked += (juce::uint64) enmascaradas;
+        metricas.sampleRate = getSampleRate();
+        metricas.load = load;
+        metricas.maxLoad = juce::jmax(metricas.maxLoad, load);
+        metricas.maskingAggressiveness = culling.getAggressiveness();
+        metricas.blockSize = buffer.getNumSamples();
+        metricas.activeVoices = activeVoices;
+        metricas.updateMs = juce::Time::getMillisecondCounter();
+
+        sharedMetrics->publish(metricas);
+    }
 }
 
 //==============================================================================
 bool SynthAudioProcessor::hasEditor() const
 {
-    return true;
+    return editorFactory.load() != nullptr;
 }
 
 juce::AudioProcessorEditor* SynthAudioProcessor::createEditor()
 {
-    return new SynthAudioProcessorEditor (*this);
+    const auto factory = editorFactory.load();
+    return factory != nullptr ? factory (*this) : nullptr;
 }
 
-//==============================================================================
-void SynthAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+void SynthAudioProcessor::setEditorFactory(EditorFactory factory)
 {
+    editorFactory.store(factory);
 }
 
-void SynthAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+//==============================================================================
+void SynthAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
 }
 
-//============================================================================== 
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+void SynthAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    return new SynthAudioProcessor();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SynthAudioProcessor::createParameters(){
@@ -220,24 +411,106 @@ juce::AudioProcessorValueTreeState::ParameterLayout SynthAudioProcessor::createP
 }
 
 void SynthAudioProcessor::updateParams() {
-    auto& cutOff = *apvts.getRawParameterValue("TONE");
-    *lpf.state = *dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(getSampleRate(), cutOff);
+    const float cutOff = toneParam->load();
+    const double sampleRate = getSampleRate();
+
+    // Se recalculan los coeficientes del paso bajo de primer orden sobre los existentes
+    // (makeFirstOrderLowPass crea un objeto nuevo en cada llamada)
+    if (sampleRate > 0.0 && (cutOff != lastCutOff || sampleRate != lastSampleRate)) {
+        const float fc = juce::jmin(cutOff, (float)sampleRate * 0.49f);
+        const float n = std::tan(juce::MathConstants<float>::pi * fc / (float)sampleRate);
+        auto* coefs = lpf.state->getRawCoefficients();
+
+        coefs[0] = n / (n + 1.0f);                  // b0
+        coefs[1] = n / (n + 1.0f);                  // b1
+        coefs[2] = (n - 1.0f) / (n + 1.0f);         // a1
+
+        lastCutOff = cutOff;
+        lastSampleRate = sampleRate;
+    }
 
-    auto& vol = *apvts.getRawParameterValue("GAIN");
-    gain.setGainDecibels(vol);
+    gain.setGainDecibels(gainParam->load());
 }
 
 std::vector <int> SynthAudioProcessor::getNumTraste() 
 {
+    const juce::SpinLock::ScopedLockType lock(visualLock);
     return numTraste;
 }
 
 std::vector <int> SynthAudioProcessor::getNumCuerda()
 {
+    const juce::SpinLock::ScopedLockType lock(visualLock);
     return numCuerda;
 }
 
 std::vector <std::vector <float>> SynthAudioProcessor::getVisual()
 {
-    return visualCuerda;
+    const juce::SpinLock::ScopedLockType lock(visualLock);
+    return { visualCuerda.begin(), visualCuerda.begin() + numVisual };
+}
+
+void SynthAudioProcessor::setVisualSnapshot(std::vector <int> cuerdas, std::vector <int> trastes, std::vector <std::vector <float>> visual)
+{
+    const juce::SpinLock::ScopedLockType lock(visualLock);
+    numCuerda = std::move(cuerdas);
+    numTraste = std::move(trastes);
+    numVisual = (int)visual.size();
+    visualCuerda = std::move(visual);
+
+    // Se mantiene la capacidad que processBlock espera encontrar
+    numCuerda.reserve(numVoices);
+    numTraste.reserve(numVoices);
+    if ((int)visualCuerda.size() < numVoices)
+        visualCuerda.resize(numVoices);
+
+    for (int i = 0; i < synth.getNumVoices(); ++i) {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+            visualCuerda[i].reserve(voice->getMaxPuntos() + 1);
+    }
+}
+
+void SynthAudioProcessor::postNoteOn(int midiNoteNumber, float velocity, int cuerda)
+{
+    uiNotes.push(midiNoteNumber, juce::jlimit(0.01f, 1.0f, velocity), cuerda);
+}
+
+void SynthAudioProcessor::postNoteOff(int midiNoteNumber)
+{
+    uiNotes.push(midiNoteNumber, 0.0f);
+}
+
+float SynthAudioProcessor::getNoteLatencyMs() const
+{
+    return uiNotes.getMaxLatencyMs();
+}
+
+void SynthAudioProcessor::setSilenceFloorDb(float newFloorDb)
+{
+    silenceFloorDb.store(newFloorDb, std::memory_order_relaxed);
+}
+
+float SynthAudioProcessor::getSilenceFloorDb() const
+{
+    return silenceFloorDb.load(std::memory_order_relaxed);
+}
+
+void SynthAudioProcessor::setMaskingCulling(float aggressiveness)
+{
+    maskingAggressiveness.store(juce::jlimit(0.0f, 1.0f, aggressiveness), std::memory_order_relaxed);
+}
+
+float SynthAudioProcessor::getMaskingCulling() const
+{
+    return maskingAggressiveness.load(std::memory_order_relaxed);
+}
+
+AudioFifo& SynthAudioProcessor::getAnalyserFifo()
+{
+    return analyserFifo;
+}
+
+const ProcessorStats& SynthAudioProcessor::getStats() const
+{
+    return stats;
 }
\ No newline at end of file
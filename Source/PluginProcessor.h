@@ -11,6 +11,14 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "NoteQueue.h"
+#include "HarpejjiSynthesiser.h"
+#include "AudioFifo.h"
+#include "RealtimeCheck.h"
+#include "ProcessorStats.h"
+#include "Trace.h"
+#include "SharedMetrics.h"
+#include "MaskingCulling.h"
 
 //==============================================================================
 /**
@@ -36,6 +44,11 @@ public:
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
+    // El editor no forma parte de harpejji_core: lo registra el plugin (createPluginFilter) o la
+    // herramienta que lo necesite. Sin él el procesador no tiene editor
+    using EditorFactory = juce::AudioProcessorEditor* (*) (SynthAudioProcessor&);
+    static void setEditorFactory(EditorFactory factory);
+
     //==============================================================================
     const juce::String getName() const override;
 
@@ -61,19 +74,70 @@ public:
     std::vector <int> getNumCuerda();
     std::vector <std::vector <float>> getVisual();
 
+    // Sustituye el estado de las cuerdas que lee el editor (benchmarks y tests del editor)
+    void setVisualSnapshot(std::vector <int> cuerdas, std::vector <int> trastes, std::vector <std::vector <float>> visual);
+
+    // Notas tocadas desde el diapasón del editor (hilo del UI). La voz suena en la cuerda indicada
+    // (-1: la elige la voz, como con el MIDI del host)
+    void postNoteOn(int midiNoteNumber, float velocity, int cuerda = -1);
+    void postNoteOff(int midiNoteNumber);
+    float getNoteLatencyMs() const;
+
+    // Nivel de la salida (dBFS) por debajo del cual se liberan las voces: el detector de cada voz
+    // tiene en cuenta GAIN y TONE. Cualquier hilo; se aplica desde el bloque siguiente
+    void setSilenceFloorDb(float newFloorDb);
+    float getSilenceFloorDb() const;
+
+    // Culling por enmascaramiento (MaskingCulling): 0 (por defecto) lo desactiva; de 0 a 1 retira
+    // voces cada vez menos tapadas por las demás. Cualquier hilo; se aplica desde el bloque siguiente
+    void setMaskingCulling(float aggressiveness);
+    float getMaskingCulling() const;
+
+    AudioFifo& getAnalyserFifo();
+    const ProcessorStats& getStats() const;
+
     juce::AudioProcessorValueTreeState apvts;
 
 private:
     const int numVoices = 6;
 
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
-    juce::Synthesiser synth;
+    NoteQueue uiNotes;
+    HarpejjiSynthesiser synth { uiNotes };          // La cuerda de las notas del editor va con cada evento de uiNotes
     dsp::ProcessorDuplicator < dsp::IIR::Filter <float>, dsp::IIR::Coefficients<float>> lpf;
     juce::dsp::Gain<float> gain;
 
+    juce::MidiBuffer mergedMidi;                    // MIDI del host + notas del editor (memoria reservada en prepareToPlay)
+
+    AudioFifo analyserFifo;                         // Salida del plugin hacia el analizador del editor
+
+    ProcessorStats stats;                           // Tiempo por bloque, voces, notas (se lee desde el editor)
+    std::unique_ptr<juce::Timer> statsLogger;       // Solo en el standalone con HARPEJJI_STATS
+    bool traceIniciada = false;                     // Esta instancia arrancó la traza (HARPEJJI_TRACE)
+
+    std::unique_ptr<SharedMetrics> sharedMetrics;   // Solo con HARPEJJI_SHM=<nombre>
+    SharedMetrics::Payload metricas;                // Copia local que se publica al final de cada bloque
+
+    // Parámetros leídos en cada bloque (se buscan una sola vez en el constructor)
+    std::atomic<float>* tensionParam = nullptr;
+    std::atomic<float>* sustainParam = nullptr;
+    std::atomic<float>* toneParam    = nullptr;
+    std::atomic<float>* gainParam    = nullptr;
+
+    std::atomic<float> silenceFloorDb { SynthVoice::pisoSilencioDefecto };
+    std::atomic<float> maskingAggressiveness { 0.0f };
+    MaskingCulling culling;                         // Solo lo usa el hilo de audio
+
+    float lastCutOff = -1.0f;                       // Último corte con el que se calcularon los coeficientes del filtro
+    double lastSampleRate = 0.0;
+
+    // Estado de las cuerdas que lee el editor. La memoria se reserva en prepareToPlay y el hilo de
+    // audio sólo copia dentro de ella; si el editor tiene el cerrojo, se salta la copia de ese bloque
+    juce::SpinLock visualLock;
     std::vector <int> numTraste;
     std::vector <int> numCuerda;
     std::vector <std::vector <float>> visualCuerda;
+    int numVisual = 0;                              // Entradas válidas de visualCuerda
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SynthAudioProcessor)
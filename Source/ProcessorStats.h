@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    ProcessorStats.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Contadores de rendimiento del procesador. El hilo de audio solo hace sumas
+// atómicas relajadas (sin locks ni memoria nueva); cualquier hilo puede leer
+// una instantánea, y la diferencia entre dos instantáneas da las cifras de ese
+// intervalo. No hay reset: así pueden leer a la vez el editor y el registro
+// del standalone sin pisarse.
+class ProcessorStats
+{
+public:
+    // Histograma del tiempo de proceso por bloque: 4 bins por octava desde 1 us
+    // (el último bin, ~65 ms, recoge todo lo que sea más lento)
+    static constexpr int numBins = 64;
+    static constexpr int binsPerOctave = 4;
+
+    static float getBinUpperUs(int bin) noexcept
+    {
+        return std::exp2((float) (bin + 1) / (float) binsPerOctave);
+    }
+
+    static int getBin(float us) noexcept
+    {
+        if (us <= 1.0f)
+            return 0;
+
+        return juce::jlimit(0, numBins - 1, (int) std::floor(std::log2(us) * (float) binsPerOctave));
+    }
+
+    struct Snapshot
+    {
+        std::array<juce::uint64, numBins> histogram {};
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numSamples = 0;
+        juce::uint64 gridPoints = 0;                // Puntos de malla x samples simulados
+        juce::uint64 noteOns = 0;
+        juce::uint64 voicesSilenced = 0;            // Voces apagadas por el detector de silencio
+        juce::uint64 droppedNotes = 0;              // Note on sin voz libre o fuera del rango de las cuerdas
+        juce::uint64 voicesQuarantined = 0;         // Voces apagadas por el monitor de energía (inestables)
+        juce::uint64 voicesMasked = 0;              // Voces retiradas por el culling por enmascaramiento
+        juce::uint64 overruns = 0;                  // Bloques que tardaron más que su duración (xruns)
+        int activeVoices = 0;                       // En el último bloque
+        float maxBlockUs = 0.0f;                    // Desde el inicio (exacto)
+        double sampleRate = 0.0;
+
+        // Percentil (0-1) del tiempo por bloque, redondeado al borde superior de su bin
+        float getPercentileUs(float p) const noexcept
+        {
+            juce::uint64 total = 0;
+            for (auto n : histogram)
+                total += n;
+
+            if (total == 0)
+                return 0.0f;
+
+            const auto objetivo = (juce::uint64) std::ceil(p * (double) total);
+            juce::uint64 acumulado = 0;
+
+            for (int b = 0; b < numBins; b++) {
+                acumulado += histogram[(size_t) b];
+                if (acumulado >= juce::jmax((juce::uint64) 1, objetivo))
+                    return getBinUpperUs(b);
+            }
+
+            return getBinUpperUs(numBins - 1);
+        }
+
+        // Borde superior del bin más lento con algún bloque
+        float getHistogramMaxUs() const noexcept
+        {
+            for (int b = numBins - 1; b >= 0; b--)
+                if (histogram[(size_t) b] > 0)
+                    return getBinUpperUs(b);
+
+            return 0.0f;
+        }
+
+        double getAudioSeconds() const noexcept
+        {
+            return sampleRate > 0.0 ? (double) numSamples / sampleRate : 0.0;
+        }
+
+        // Cifras del intervalo entre 'anterior' y esta instantánea
+        Snapshot since(const Snapshot& anterior) const noexcept
+        {
+            Snapshot d = *this;
+
+            for (size_t b = 0; b < histogram.size(); b++)
+                d.histogram[b] -= juce::jmin(histogram[b], anterior.histogram[b]);
+
+            d.numBlocks      -= juce::jmin(numBlocks, anterior.numBlocks);
+            d.numSamples     -= juce::jmin(numSamples, anterior.numSamples);
+            d.gridPoints     -= juce::jmin(gridPoints, anterior.gridPoints);
+            d.noteOns        -= juce::jmin(noteOns, anterior.noteOns);
+            d.voicesSilenced -= juce::jmin(voicesSilenced, anterior.voicesSilenced);
+            d.droppedNotes   -= juce::jmin(droppedNotes, anterior.droppedNotes);
+            d.voicesQuarantined -= juce::jmin(voicesQuarantined, anterior.voicesQuarantined);
+            d.voicesMasked   -= juce::jmin(voicesMasked, anterior.voicesMasked);
+            d.overruns       -= juce::jmin(overruns, anterior.overruns);
+            return d;
+        }
+
+        // Resumen en una línea por cifra (overlay del editor y registro del standalone).
+        // Las tasas son por segundo de audio procesado.
+        juce::StringArray describe() const
+        {
+            const double segundos = getAudioSeconds();
+            auto porSegundo = [segundos](juce::uint64 n) { return segundos > 0.0 ? (double) n / segundos : 0.0; };
+            const double bloqueUs = numBlocks > 0 && sampleRate > 0.0 ? 1.0e6 * (double) numSamples / (sampleRate * (double) numBlocks) : 0.0;
+
+            juce::StringArray lineas;
+            lineas.add("bloque p50 " + juce::String(juce::roundToInt(getPercentileUs(0.5f))) + " us  p99 " + juce::String(juce::roundToInt(getPercentileUs(0.99f)))
+                       + " us  max " + juce::String(juce::roundToInt(getHistogramMaxUs())) + " us  (pico " + juce::String(juce::roundToInt(maxBlockUs)) + " us)");
+            lineas.add("carga p99 " + juce::String(bloqueUs > 0.0 ? 100.0 * getPercentileUs(0.99f) / bloqueUs : 0.0, 1) + " %  bloques de "
+                       + juce::String(juce::roundToInt(bloqueUs)) + " us  xruns " + juce::String((juce::int64) overruns));
+            lineas.add("voces " + juce::String(activeVoices) + "  puntos/s " + juce::String(porSegundo(gridPoints) / 1.0e6, 2) + " M");
+            lineas.add("note on/s " + juce::String(porSegundo(noteOns), 1) + "  silenciadas/s " + juce::String(porSegundo(voicesSilenced), 1)
+                       + "  enmascaradas/s " + juce::String(porSegundo(voicesMasked), 1)
+                       + "  perdidas " + juce::String((juce::int64) droppedNotes) + "  inestables " + juce::String((juce::int64) voicesQuarantined));
+            return lineas;
+        }
+    };
+
+    //==============================================================================
+    // Hilo de audio
+
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        sampleRate.store(newSampleRate, std::memory_order_relaxed);
+    }
+
+    void addBlock(float blockUs, int numSamplesInBlock, int numActiveVoices, juce::int64 gridPointsInBlock,
+                  int noteOnsInBlock, int silencedInBlock, int droppedInBlock, int quarantinedInBlock, int maskedInBlock) noexcept
+    {
+        histogram[(size_t) getBin(blockUs)].fetch_add(1, std::memory_order_relaxed);
+        numBlocks.fetch_add(1, std::memory_order_relaxed);
+        numSamples.fetch_add((juce::uint64) numSamplesInBlock, std::memory_order_relaxed);
+        gridPoints.fetch_add((juce::uint64) gridPointsInBlock, std::memory_order_relaxed);
+        noteOns.fetch_add((juce::uint64) noteOnsInBlock, std::memory_order_relaxed);
+        voicesSilenced.fetch_add((juce::uint64) silencedInBlock, std::memory_order_relaxed);
+        droppedNotes.fetch_add((juce::uint64) droppedInBlock, std::memory_order_relaxed);
+        voicesQuarantined.fetch_add((juce::uint64) quarantinedInBlock, std::memory_order_relaxed);
+        voicesMasked.fetch_add((juce::uint64) maskedInBlock, std::memory_order_relaxed);
+        activeVoices.store(numActiveVoices, std::memory_order_relaxed);
+
+        const double rate = sampleRate.load(std::memory_order_relaxed);
+        if (rate > 0.0 && blockUs > (float) (1.0e6 * numSamplesInBlock / rate))
+            overruns.fetch_add(1, std::memory_order_relaxed);
+
+        if (blockUs > maxBlockUs.load(std::memory_order_relaxed))
+            maxBlockUs.store(blockUs, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    // Cualquier hilo
+
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot s;
+
+        for (size_t b = 0; b < histogram.size(); b++)
+            s.histogram[b] = histogram[b].load(std::memory_order_relaxed);
+
+        s.numBlocks      = numBlocks.load(std::memory_order_relaxed);
+        s.numSamples     = numSamples.load(std::memory_order_relaxed);
+        s.gridPoints     = gridPoints.load(std::memory_order_relaxed);
+        s.noteOns        = noteOns.load(std::memory_order_relaxed);
+        s.voicesSilenced = voicesSilenced.load(std::memory_order_relaxed);
+        s.droppedNotes   = droppedNotes.load(std::memory_order_relaxed);
+        s.voicesQuarantined = voicesQuarantined.load(std::memory_order_relaxed);
+        s.voicesMasked   = voicesMasked.load(std::memory_order_relaxed);
+        s.overruns       = overruns.load(std::memory_order_relaxed);
+        s.activeVoices   = activeVoices.load(std::memory_order_relaxed);
+        s.maxBlockUs     = maxBlockUs.load(std::memory_order_relaxed);
+        s.sampleRate     = sampleRate.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    std::array<std::atomic<juce::uint64>, numBins> histogram {};
+    std::atomic<juce::uint64> numBlocks { 0 };
+    std::atomic<juce::uint64> numSamples { 0 };
+    std::atomic<juce::uint64> gridPoints { 0 };
+    std::atomic<juce::uint64> noteOns { 0 };
+    std::atomic<juce::uint64> voicesSilenced { 0 };
+    std::atomic<juce::uint64> droppedNotes { 0 };
+    std::atomic<juce::uint64> voicesQuarantined { 0 };
+    std::atomic<juce::uint64> voicesMasked { 0 };
+    std::atomic<juce::uint64> overruns { 0 };
+    std::atomic<int> activeVoices { 0 };
+    std::atomic<float> maxBlockUs { 0.0f };
+    std::atomic<double> sampleRate { 0.0 };
+};
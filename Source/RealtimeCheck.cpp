@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+#include <atomic>
+
+namespace rtcheck
+{
+    namespace
+    {
+        thread_local int profundidad = 0;
+        std::atomic<long> infracciones { 0 };
+    }
+
+    bool isAudioThread() noexcept
+    {
+        return profundidad > 0;
+    }
+
+    ScopedAudioThread::ScopedAudioThread() noexcept
+    {
+        ++profundidad;
+    }
+
+    ScopedAudioThread::~ScopedAudioThread() noexcept
+    {
+        --profundidad;
+    }
+
+    long getNumViolations() noexcept
+    {
+        return infracciones.load();
+    }
+
+    void addViolation() noexcept
+    {
+        infracciones++;
+    }
+}
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+    Created: 19 Oct 2026
+
+    Marca del hilo que está ejecutando processBlock. Por sí sola no hace nada
+    (una escritura thread_local por bloque); en los builds de comprobación se
+    enlazan además los interceptores de Tools/RtCheck, que usan esta marca para
+    avisar de reservas de memoria, locks y llamadas al sistema bloqueantes
+    hechas desde el callback de audio.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace rtcheck
+{
+    // true mientras el hilo actual esté dentro de un ScopedAudioThread
+    bool isAudioThread() noexcept;
+
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+
+        ScopedAudioThread(const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator=(const ScopedAudioThread&) = delete;
+    };
+
+    // Número de infracciones detectadas por los interceptores (0 si no están enlazados)
+    long getNumViolations() noexcept;
+    void addViolation() noexcept;
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    SharedMetrics.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "SharedMetrics.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <cerrno>
+ #include <csignal>
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define HARPEJJI_SHM_POSIX 1
+#endif
+
+static_assert(std::atomic<juce::uint32>::is_always_lock_free, "El seqlock necesita atómicos sin lock entre procesos");
+static_assert(std::is_trivially_copyable<SharedMetrics::Payload>::value, "Payload se copia byte a byte");
+
+#if HARPEJJI_SHM_POSIX
+namespace
+{
+    // Un segmento con el magic de Harpejji cuyo proceso ya no existe (p. ej. tras un cierre
+    // inesperado) se puede reutilizar
+    bool esHuerfano(const juce::String& nombre)
+    {
+        const int fd = shm_open(nombre.toRawUTF8(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat info {};
+        void* p = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size >= (off_t) sizeof(SharedMetrics::Layout))
+            p = mmap(nullptr, sizeof(SharedMetrics::Layout), PROT_READ, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (p == MAP_FAILED)
+            return false;
+
+        const auto* l = static_cast<const SharedMetrics::Layout*>(p);
+        const bool huerfano = l->magic == SharedMetrics::magic && l->pid > 0
+                               && kill((pid_t) l->pid, 0) != 0 && errno == ESRCH;
+
+        munmap(p, sizeof(SharedMetrics::Layout));
+        return huerfano;
+    }
+}
+#endif
+
+std::unique_ptr<SharedMetrics> SharedMetrics::create(const juce::String& name)
+{
+   #if HARPEJJI_SHM_POSIX
+    const auto base = name.startsWithChar('/') ? name : "/" + name;
+
+    // O_EXCL: nunca se pisa el segmento de otra instancia (ni se borra al destruir esta).
+    // Si el nombre está cogido se prueba con <nombre>-2, <nombre>-3...
+    juce::String nombre;
+    int fd = -1;
+
+    for (int i = 1; i <= maxSufijos && fd < 0; i++) {
+        nombre = i == 1 ? base : base + "-" + juce::String(i);
+        fd = shm_open(nombre.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+        if (fd < 0 && errno == EEXIST && esHuerfano(nombre)) {
+            shm_unlink(nombre.toRawUTF8());
+            fd = shm_open(nombre.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        }
+
+        if (fd < 0 && errno != EEXIST)
+            return nullptr;
+    }
+
+    if (fd < 0)
+        return nullptr;
+
+    void* p = MAP_FAILED;
+    if (ftruncate(fd, (off_t) sizeof(Layout)) == 0)
+        p = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (p == MAP_FAILED) {
+        shm_unlink(nombre.toRawUTF8());
+        return nullptr;
+    }
+
+    // Se inicializa (y se tocan las páginas) aquí, no en el primer bloque
+    auto* layout = new (p) Layout();
+    layout->magic = magic;
+    layout->version = version;
+    layout->sequence.store(0);
+    layout->pid = (juce::int32) getpid();
+    layout->payload = {};
+
+    return std::unique_ptr<SharedMetrics>(new SharedMetrics(nombre, layout));
+   #else
+    juce::ignoreUnused(name);
+    return nullptr;
+   #endif
+}
+
+SharedMetrics::SharedMetrics(const juce::String& name, Layout* mapped) noexcept
+    : nombre(name), layout(mapped)
+{
+}
+
+SharedMetrics::~SharedMetrics()
+{
+   #if HARPEJJI_SHM_POSIX
+    munmap(layout, sizeof(Layout));
+    shm_unlink(nombre.toRawUTF8());
+   #endif
+}
+
+void SharedMetrics::publish(const Payload& p) noexcept
+{
+    const auto s = layout->sequence.load(std::memory_order_relaxed);
+
+    layout->sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&layout->payload, &p, sizeof(Payload));
+
+    layout->sequence.store(s + 2, std::memory_order_release);
+}
+
+bool SharedMetrics::read(const Layout& l, Payload& dest) noexcept
+{
+    if (l.magic != magic || l.version != version)
+        return false;
+
+    for (int intento = 0; intento < 100; intento++) {
+        const auto s1 = l.sequence.load(std::memory_order_acquire);
+        if (s1 & 1u)
+            continue;
+
+        std::memcpy(&dest, &l.payload, sizeof(Payload));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (l.sequence.load(std::memory_order_relaxed) == s1)
+            return true;
+    }
+
+    return false;
+}
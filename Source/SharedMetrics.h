@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    SharedMetrics.h
+    Created: 19 Oct 2026
+
+    Métricas del procesador publicadas en un segmento de memoria compartida
+    POSIX, para monitorizar instancias del standalone sin pantalla desde otro
+    proceso (Tools/Monitor). El hilo de audio escribe al final de cada bloque
+    con un seqlock: nunca espera al lector, y el lector reintenta si la
+    escritura coincide con su lectura. Se activa con HARPEJJI_SHM=<nombre>.
+
+    Solo Linux y macOS; en el resto de plataformas create() devuelve nullptr.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class SharedMetrics
+{
+public:
+    static constexpr juce::uint32 magic = 0x48524a4d;     // "HRJM"
+    static constexpr juce::uint32 version = 3;
+
+    // Datos publicados. Todo es POD de tamaño fijo para que el lector pueda
+    // ser cualquier proceso (o lenguaje) que conozca esta disposición.
+    struct Payload
+    {
+        juce::uint64 numBlocks = 0;
+        juce::uint64 xruns = 0;                     // Bloques que tardaron más que su duración
+        juce::uint64 voicesSilenced = 0;            // Voces apagadas por el detector de silencio
+        juce::uint64 droppedNotes = 0;
+        juce::uint64 voicesQuarantined = 0;         // Voces apagadas por el monitor de energía (inestables)
+        juce::uint64 voicesMasked = 0;              // Voces retiradas por el culling por enmascaramiento
+        double       sampleRate = 0.0;
+        float        load = 0.0f;                   // Tiempo de proceso / duración del último bloque
+        float        maxLoad = 0.0f;                // Máximo desde el inicio
+        float        maskingAggressiveness = 0.0f;  // Del culling por enmascaramiento (0: desactivado)
+        juce::int32  blockSize = 0;                 // Samples del último bloque
+        juce::int32  activeVoices = 0;
+        juce::int32  qualityTier = 0;               // El motor tiene un único nivel de calidad (siempre 0)
+        juce::uint32 updateMs = 0;                  // Time::getMillisecondCounter() de la última escritura
+    };
+
+    struct Layout
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        std::atomic<juce::uint32> sequence;         // Impar mientras se escribe
+        juce::int32  pid;
+        Payload      payload;
+    };
+
+    // Hilo de mensajes. 'name' sigue las reglas de shm_open (se añade '/' si falta).
+    // Si otra instancia viva ya lo usa se añade un sufijo (-2, -3... hasta maxSufijos);
+    // getName() devuelve el nombre final. nullptr si no queda ninguno libre.
+    static std::unique_ptr<SharedMetrics> create(const juce::String& name);
+    static constexpr int maxSufijos = 16;
+    ~SharedMetrics();
+
+    // Hilo de audio: sin locks ni llamadas al sistema
+    void publish(const Payload& p) noexcept;
+
+    // Lector (cualquier proceso). Devuelve false si no consigue una copia
+    // coherente tras unos cuantos intentos.
+    static bool read(const Layout& layout, Payload& dest) noexcept;
+
+    const juce::String& getName() const noexcept { return nombre; }
+
+private:
+    SharedMetrics(const juce::String& name, Layout* mapped) noexcept;
+
+    juce::String nombre;
+    Layout* layout = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMetrics)
+};
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    StatsComponent.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "StatsComponent.h"
+
+StatsComponent::StatsComponent(const ProcessorStats& s)
+    : stats(s)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+StatsComponent::~StatsComponent()
+{
+}
+
+void StatsComponent::visibilityChanged()
+{
+    if (isVisible()) {
+        anterior = stats.getSnapshot();
+        intervalo = {};
+        startTimerHz(1);
+    }
+    else
+        stopTimer();
+}
+
+void StatsComponent::timerCallback()
+{
+    const auto actual = stats.getSnapshot();
+    intervalo = actual.since(anterior);
+    anterior = actual;
+    repaint();
+}
+
+void StatsComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(0.75f));
+
+    auto area = getLocalBounds().toFloat().reduced(6.0f, 4.0f);
+    const auto lineas = intervalo.describe();
+
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(12.0f);
+
+    for (const auto& linea : lineas)
+        g.drawText(linea, area.removeFromTop(15.0f), juce::Justification::centredLeft);
+
+    // Histograma del tiempo por bloque (escala log en ambos ejes), con la duración de un bloque marcada
+    area.removeFromTop(4.0f);
+    if (area.getHeight() < 8.0f)
+        return;
+
+    juce::uint64 maximo = 0;
+    int primero = ProcessorStats::numBins, ultimo = -1;
+
+    for (int b = 0; b < ProcessorStats::numBins; b++) {
+        const auto n = intervalo.histogram[(size_t) b];
+        maximo = juce::jmax(maximo, n);
+        if (n > 0) {
+            primero = juce::jmin(primero, b);
+            ultimo = b;
+        }
+    }
+
+    if (maximo == 0)
+        return;
+
+    primero = juce::jmax(0, primero - 2);
+    ultimo = juce::jmin(ProcessorStats::numBins - 1, ultimo + 2);
+
+    const float anchoBin = area.getWidth() / (float) (ultimo - primero + 1);
+    const float escala = std::log1p((float) maximo);
+
+    g.setColour(juce::Colours::orange);
+    for (int b = primero; b <= ultimo; b++) {
+        const float h = area.getHeight() * std::log1p((float) intervalo.histogram[(size_t) b]) / escala;
+        g.fillRect(area.getX() + (float) (b - primero) * anchoBin + 1.0f, area.getBottom() - h, anchoBin - 2.0f, h);
+    }
+
+    if (intervalo.numBlocks > 0 && intervalo.sampleRate > 0.0) {
+        const float bloqueUs = (float) (1.0e6 * (double) intervalo.numSamples / (intervalo.sampleRate * (double) intervalo.numBlocks));
+        const float pos = (std::log2(bloqueUs) * (float) ProcessorStats::binsPerOctave - (float) primero) * anchoBin;
+
+        if (pos >= 0.0f && pos <= area.getWidth()) {
+            g.setColour(juce::Colours::red);
+            g.drawVerticalLine((int) (area.getX() + pos), area.getY(), area.getBottom());
+        }
+    }
+}
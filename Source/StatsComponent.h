@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    StatsComponent.h
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorStats.h"
+
+// Overlay con las estadísticas del procesador del último segundo: tiempo por
+// bloque (p50/p99/max e histograma), voces activas, puntos de malla simulados
+// por segundo, note on por segundo, voces apagadas por el detector de nivel y
+// notas perdidas.
+class StatsComponent : public juce::Component
+    ,   private juce::Timer
+{
+public:
+    explicit StatsComponent(const ProcessorStats& s);
+    ~StatsComponent() override;
+
+    void paint(juce::Graphics&) override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+
+    const ProcessorStats& stats;
+    ProcessorStats::Snapshot anterior;
+    ProcessorStats::Snapshot intervalo;             // Diferencia entre las dos últimas instantáneas
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StatsComponent)
+};
@@ -17,63 +17,117 @@ bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound) {
 }
 
 void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) {
-    if (juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber) > 65.40f && juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber) < 1047)
-        setInitialConditions(velocity, juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+    HARPEJJI_TRACE_SCOPE("noteOn", midiNoteNumber);
+
+    if (juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber) > 65.40f && juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber) < 1047) {
+        setInitialConditions(velocity, juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber),
+                             cuerdaPedida != nullptr ? *cuerdaPedida : -1);
+        blockStats.notasIniciadas++;
+
+        // La nota empieza con el bend actual y sin deslizamiento
+        pitchWheelMoved(currentPitchWheelPosition);
+        deslizamiento = 0.0f;
+        semitonos.setCurrentAndTargetValue(bend);
+        if (bend != 0.0f)
+            moverFrontera(calcularFrontera(bend));
+
+        energiaNota = calcularEnergia().total;
+        energiaMinima = energiaNota;
+        fronteraMovida = false;
+
+        samplesNota = 0;
+        nivelSalidaDb = 0.0f;
+        retirando = false;
+    }
     else
         clearCurrentNote();
 }
 
 void SynthVoice::stopNote(float velocity, bool allowTailOff) {
     s0 = 200 * s0;
+    calcularCoeficientes();
 }
 
 void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue) {
-
+    if (controllerNumber == ccDeslizamiento) {
+        deslizamiento = rangoDeslizamiento * (float)jlimit(0, 127, newControllerValue) / 127.0f;
+        semitonos.setTargetValue(bend + deslizamiento);
+    }
 }
 
 void SynthVoice::pitchWheelMoved(int newPitchWheelValue) {
-
+    const int centrado = jlimit(0, 16383, newPitchWheelValue) - 8192;
+    bend = rangoBend * (float)centrado / (centrado > 0 ? 8191.0f : 8192.0f);
+    semitonos.setTargetValue(bend + deslizamiento);
 }
 
 void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels) {
-    alfa = (1000.0f / timeDet) * (1.0f / getSampleRate());
     dt = 1.0f / (float)getSampleRate();           // Periodo de muestreo
+
+    // dx >= c * dt siempre (límite de estabilidad sin rigidez), así que la cuerda más larga en
+    // puntos es la nota más grave (65.4 Hz): X <= L / (c * dt) = 1 / (2 * f * dt * sqrt(1 - B)),
+    // sea cual sea la tensión (L y c son proporcionales a tMult). El bend hacia abajo la alarga.
+    maxPuntos = (int)ceil(exp2f(rangoBend / 12.0f) / (2.0f * Strings[0][0] * dt * sqrtf(1.0f - Bmax))) + 2;
+
+    semitonos.reset(getSampleRate(), 0.01);
+
+    v0.reserve(maxPuntos + 1);
+    yPrev.reserve(maxPuntos + 3);
+    y.reserve(maxPuntos + 3);
+    yNext.reserve(maxPuntos + 3);
+    thomasC.reserve(maxPuntos + 1);
+    thomasInv.reserve(maxPuntos + 1);
+    visualCuerda.reserve(maxPuntos + 1);
+
+    synthBuffer.setSize(1, samplesPerBlock);
+
     isPrepared = true;
 }
 
-void SynthVoice::setInitialConditions(float velocity, double frequency) {    // Velocity y Frequency valor
+void SynthVoice::setInitialConditions(float velocity, double frequency, int cuerda) {    // Velocity y Frequency valor
     gamma = 2.0f * frequency;
-    dx = gamma * dt / lambda;                     // Paso de muestreo espacial
+    theta = thetaSiguiente;
+    orden = ordenSiguiente;
 
-    numCuerda = 0;
+    // La cuerda pedida, si la nota no queda por debajo de la cuerda al aire; si no, la primera
+    // cuerda en cuyos primeros trastes (según pos) está la nota
+    if (cuerda >= 0 && cuerda < 16 && frequency >= Strings[0][cuerda] * 0.99f) {
+        numCuerda = cuerda;
+    }
+    else {
+        numCuerda = 0;
 
-    while (frequency > (Strings[0][numCuerda] * powf(2, 3.0f * pos / 12.0f)) && numCuerda < 15) {
-        numCuerda++;
+        while (frequency > (Strings[0][numCuerda] * powf(2, 3.0f * pos / 12.0f)) && numCuerda < 15) {
+            numCuerda++;
+        }
     }
 
     numTraste = (int) round(12.0f * log2f(frequency / Strings[0][numCuerda])) + 1;
 
     c0 = 2 * L_esc * Strings[0][numCuerda];
-    c = c0 * tMult;
 
-    //r =  Strings [1] [i] / 2;
-    //S = r * juce::float_Pi * juce::float_Pi;        // Área de la sección de la cuerda
-    //K = r / 2.0f;
+    // Longitud de la cuerda. Con calibración se afina la cuerda continua unos cents por encima o
+    // por debajo de la nota para compensar la dispersión de la malla
+    notaCuerda = 69.0f + 12.0f * log2f((float)frequency / 440.0f);
+    tensionCuerda = tMult;
+    const float cents = calibracion != nullptr ? calibracion->getCorrectionCents(notaCuerda, tensionCuerda) : 0.0f;
 
-    // Longitud de la cuerda
-    float L = c / (2.0f * frequency);                   // Longitud de la cuerda en metros
-    X = (int)floor(L / dx);                             // Longitud de la cuerda en número de pasos dx
-    dx = L / X;                                         //
+    const double fCuerda = frequency * pow(2.0, cents / 1200.0);
 
-    k = sqrtf(0.001f) * (gamma / juce::float_Pi);       // Estabilidad
+    float L = c0 * tMult / (2.0f * (float)fCuerda);     // Longitud de la cuerda en metros
 
-    int xCtr = (int)floor(X * ctr);
-    xRead = (int)floor(X * read);
+    // Rigidez: B se calcula con la cuerda real de acero (kappa = d/4 * sqrt(E/rho), longitud de
+    // escala L_real) y se pasa a la cuerda del modelo conservando B. La velocidad se reduce para
+    // que la fundamental, c/(2L) * sqrt(1 + B), siga siendo la de la nota.
+    const float kappaReal = 0.25f * Strings[2][numCuerda] * sqrtf(E / rho);
+    const float cReal = 2.0f * L_real * Strings[0][numCuerda] * tMult;
+    const float Bnom = jmin(Bmax, powf(2.0f * float_Pi * kappaReal * (float)frequency / (cReal * cReal), 2.0f));
 
-    v0 = std::vector<float>((X + 1), 0);                //
-    yPrev = v0;                                         // Se inicializan a 0
-    y = v0;                                             //
-    yNext = v0;                                         //
+    kappa = sqrtf(Bnom) * c0 * tMult * L / float_Pi;
+    c = c0 * tMult * sqrtf(1.0f - Bnom);
+    B = Bnom / (1.0f - Bnom);
+
+    k = sqrtf(0.001f) * (gamma / juce::float_Pi);       // Estabilidad
 
     // Coeficiente de atenuación lineal
     s0 = decMult * (xi(loss[0][1]) / loss[1][0] - xi(loss[0][0]) / loss[1][1]) * 6.0 * logf(10) / (xi(loss[0][1]) - xi(loss[0][0]));
@@ -81,10 +135,35 @@ void SynthVoice::setInitialConditions(float velocity, double frequency) {    //
     // Coeficiente de atenuación dependiente de la frecuencia
     s1 = decMult * (-1 / loss[1][0] + 1 / loss[1][1]) * 6 * log(10) / (xi(loss[0][1]) - xi(loss[0][0]));
 
+    // Malla: la más fina estable, escalada por lambda
+    X = (int)floor(lambda * L / calcularDxMin());       // Longitud de la cuerda en número de pasos dx
+    X = jlimit(4, jmax(4, maxPuntos), X);               // Con mallas muy gruesas X puede quedar por debajo de 4
+    dx = L / X;                                         //
+    xCapacidad = jmin(jmax(4, maxPuntos), (int)ceil(X * exp2f(rangoBend / 12.0f)));
+
+    int xCtr = (int)floor(X * ctr);
+    xRead = (int)floor(X * read);
+
+    v0.assign(X + 1, 0.0f);                             //
+    yPrev.assign(xCapacidad + 3, 0.0f);                 // Se inicializan a 0 (sin reservar memoria:
+    y.assign(xCapacidad + 3, 0.0f);                     // la capacidad se reserva en prepareToPlay)
+    yNext.assign(xCapacidad + 3, 0.0f);                 //
+    thomasC.assign(xCapacidad + 1, 0.0f);               //
+    thomasInv.assign(xCapacidad + 1, 0.0f);             //
+
+    // Extremo en el punto X (sin bend): el fantasma X es 0 y el X + 1 es -y[X - 1]
+    xFin = X - 1;
+    moverFrontera((float)X);
+
+    calcularCoeficientes();
+
     // Se establecen las condiciones iniciales en la cuerda -> Velocidad inicial en en la cuerda tras ser pulsada.
 
-    // Se inicializa el detector de nivel a 1 para que no se apague inmediatamente la voz
-    c2n = 1;
+    // La fundamental con amplitud A tiene energía (omega dt)^2 A^2 xFin / 2 y da en la pastilla una
+    // potencia media de sin^2(pi read) A^2 / 2
+    frecuenciaNota = (float)frequency;
+    const float omegaNota = 2.0f * float_Pi * frecuenciaNota * dt;
+    escalaPotencia = powf(sinf(float_Pi * read), 2.0f) / (omegaNota * omegaNota);
 
     // Tipo de excitación
     int excitacion = 4;
@@ -126,7 +205,7 @@ void SynthVoice::setInitialConditions(float velocity, double frequency) {    //
             break;
     }
 
-    float kn = 2 * float_Pi * frequency / c;                        // Cálculo del número de onda k
+    float kn = float_Pi / L;                                        // Cálculo del número de onda k
     float integral = 0;
 
     for (int x = 0; x < X; x++) {                                   //
@@ -140,7 +219,100 @@ void SynthVoice::setInitialConditions(float velocity, double frequency) {    //
     }
 
     for (int x = 0; x < X; x++)                                     // Se calcula la posición de la cuerda en el instante siguiente
-        y[x] = v0[x] * dt;
+        y[x + 1] = v0[x] * dt;
+
+    y[0] = -y[2];
+    actualizarFantasmas(y.data() + 1);
+}
+
+// Límite de estabilidad del esquema. Con una onda sin(beta x) y s = sin^2(beta dx / 2), el esquema
+// es estable si dt^2 * (símbolo de los operadores espaciales) = p1 s + p2 s^2 queda en [0, 4] para
+// todo s en [0, 1]. Con segundo orden eso da dx^2 >= (a + sqrt(a^2 + 16 kappa^2 dt^2)) / 2, con
+// a = c^2 dt^2 + 4 (1 - theta) s1 dt (sin rigidez ni pérdidas explícitas, dx >= c dt: Courant <= 1).
+// Con cuarto orden p2 puede ser negativo y se busca dx por bisección.
+
+float SynthVoice::calcularDxMin() {
+    const double a = (double)c * c * dt * dt + 4.0 * (1.0 - theta) * s1 * dt;
+    const double dxSegundoOrden = sqrt(0.5 * (a + sqrt(a * a + 16.0 * (double)kappa * kappa * dt * dt)));
+
+    if (orden == 2)
+        return (float)dxSegundoOrden;
+
+    const double kappaEf2 = (double)kappa * kappa - pow((double)c, 4) * dt * dt / 12.0;
+
+    auto esEstable = [&](double h) {
+        const double lambda2 = (double)c * c * dt * dt / (h * h);
+        const double p1 = 4.0 * lambda2 + 16.0 * (1.0 - theta) * s1 * dt / (h * h);
+        const double p2 = (4.0 / 3.0) * lambda2 + 16.0 * kappaEf2 * dt * dt / (h * h * h * h);
+        const double maximo = (p2 >= 0.0 || -p1 / (2.0 * p2) >= 1.0) ? p1 + p2 : -p1 * p1 / (4.0 * p2);
+        return maximo <= 4.0 && p1 + p2 >= 0.0;
+    };
+
+    double inestable = 0.25 * dxSegundoOrden;
+    double estable = 2.0 * dxSegundoOrden;
+
+    for (int i = 0; i < 40; i++) {
+        const double h = 0.5 * (inestable + estable);
+        if (esEstable(h))
+            estable = h;
+        else
+            inestable = h;
+    }
+
+    return (float)estable;
+}
+
+// Coeficientes del esquema de la cuerda rígida con pérdidas. Las pérdidas dependientes de la
+// frecuencia se mezclan entre la diferencia hacia atrás (explícita) y la centrada (implícita):
+// (1 + s0 dt) y+ = 2y - (1 - s0 dt) y- + dt^2 (c^2 Dxx - kappa^2 Dxxxx) y
+//                  + 2 s1 dt Dxx ((1 - theta) (y - y-) + theta (y+ - y-) / 2)
+// Con cuarto orden, c^2 Dxx usa 5 puntos y a la rigidez se le resta c^4 dt^2 / 12: así se
+// cancela también el error de segundo orden de la derivada temporal (ecuación modificada).
+// Los dos órdenes usan 5 puntos por la rigidez, así que cuestan lo mismo por punto.
+//
+// Se calcula el incremento w = y+ - y con diferencias (D1 = y[x-1] + y[x+1] - 2y,
+// D2 = y[x-2] + y[x+2] - 2y): con los coeficientes de y, y- sueltos (cerca de 2 y -1) el
+// redondeo a float desafinaba las notas graves hasta un par de cents, porque la fundamental
+// depende de diferencias entre ellos del orden de (2 pi f dt)^2.
+
+void SynthVoice::calcularCoeficientes() {
+    const float lambda2 = c * c * dt * dt / (dx * dx);                      // Número de Courant al cuadrado
+    const float kappa2 = orden == 4 ? kappa * kappa - powf(c, 4) * dt * dt / 12.0f : kappa * kappa;
+    const float mu2 = kappa2 * dt * dt / (dx * dx * dx * dx);               // Rigidez
+    const float sigma = s1 * dt / (dx * dx);                                // Pérdidas dependientes de la frecuencia
+    const float diagonal = 1.0f + s0 * dt + 2.0f * theta * sigma;
+
+    // Con theta = 0 se divide aquí por la diagonal; si no, lo hace el solver
+    const float den = theta > 0.0f ? 1.0f : diagonal;
+
+    // Dxx de 3 puntos (D1) o de 5 puntos ((16 D1 - D2) / 12); Dxxxx = D2 - 4 D1
+    const float d1 = orden == 4 ? 4.0f / 3.0f : 1.0f;
+    const float d2 = orden == 4 ? -1.0f / 12.0f : 0.0f;
+
+    k1 = d1 * lambda2 + 4.0f * mu2;
+    k2 = d2 * lambda2 - mu2;
+    kv = (1.0f - theta) * sigma;
+
+    aVel = (1.0f - s0 * dt) / den;
+    a1 = (k1 + 2.0f * (1.0f - theta) * sigma + theta * sigma) / den;
+    a2 = k2 / den;
+    b1 = -(2.0f - theta) * sigma / den;
+
+    if (theta > 0.0f) {
+        // Factorización de Thomas de A (filas 1 a xCapacidad - 1; los extremos son fijos). A no
+        // cambia hasta la siguiente nota o stopNote, así que por sample solo quedan las dos pasadas.
+        // La factorización de las primeras filas no depende de las siguientes: con el extremo en
+        // cualquier punto se resuelve con las filas 1 a xFin (las pérdidas implícitas toman el
+        // extremo en xFin + 1, no en la posición fraccionaria)
+        aFuera = -theta * sigma;
+
+        float cAnterior = 0.0f;
+        for (int x = 1; x < xCapacidad; x++) {
+            thomasInv[x] = 1.0f / (diagonal - aFuera * cAnterior);
+            thomasC[x] = aFuera * thomasInv[x];
+            cAnterior = thomasC[x];
+        }
+    }
 }
 
 void SynthVoice::updateParams(const float tension, const float sustain) {
@@ -148,60 +320,352 @@ void SynthVoice::updateParams(const float tension, const float sustain) {
     decMult = sustain;
 }
 
+void SynthVoice::setGridScale(float newLambda) {
+    lambda = jlimit(0.1f, 1.0f, newLambda);
+}
+
+void SynthVoice::setLossTheta(float newTheta) {
+    thetaSiguiente = jlimit(0.0f, 1.0f, newTheta);
+}
+
+void SynthVoice::setSpatialOrder(int newOrder) {
+    ordenSiguiente = newOrder >= 4 ? 4 : 2;
+}
+
+// Cálculo de la posición de la cuerda en el sample siguiente (ecuación de onda, rigidez y pérdidas)
+
+void SynthVoice::calcularSiguiente() {
+    // Punteros al punto 0 de cada instante: u[-1], u[xFin + 1] y u[xFin + 2] son los puntos fantasma
+    const float* __restrict u = y.data() + 1;
+    const float* __restrict uPrev = yPrev.data() + 1;
+    float* __restrict uNext = yNext.data() + 1;
+
+    if (theta == 0.0f) {
+        for (int x = 1; x <= xFin; x++) {
+            uNext[x] = u[x] + aVel * (u[x] - uPrev[x])
+                     + a1 * (u[x - 1] + u[x + 1] - 2.0f * u[x])
+                     + a2 * (u[x - 2] + u[x + 2] - 2.0f * u[x])
+                     + b1 * (uPrev[x - 1] + uPrev[x + 1] - 2.0f * uPrev[x]);
+        }
+    }
+    else {
+        for (int x = 1; x <= xFin; x++) {
+            uNext[x] = aVel * (u[x] - uPrev[x])
+                     + a1 * (u[x - 1] + u[x + 1] - 2.0f * u[x])
+                     + a2 * (u[x - 2] + u[x + 2] - 2.0f * u[x])
+                     + b1 * (uPrev[x - 1] + uPrev[x + 1] - 2.0f * uPrev[x]);
+        }
+
+        // Pérdidas implícitas: se resuelve A w = (lo calculado) con la factorización de Thomas
+        uNext[1] *= thomasInv[1];
+        for (int x = 2; x <= xFin; x++)
+            uNext[x] = (uNext[x] - aFuera * uNext[x - 1]) * thomasInv[x];
+        for (int x = xFin - 1; x >= 1; x--)
+            uNext[x] -= thomasC[x] * uNext[x + 1];
+
+        for (int x = 1; x <= xFin; x++)
+            uNext[x] += u[x];
+    }
+
+    uNext[-1] = -uNext[1];                                          // Extremos apoyados
+    actualizarFantasmas(uNext);                                     //
+}
+
+// Pitch bend y deslizamiento. La cuerda conserva dx, c y kappa: solo cambia su longitud, que pasa a
+// ser frontera * dx. El extremo móvil es apoyado como el fijo: los puntos fantasma son la reflexión
+// impar de la cuerda respecto a él, interpolada linealmente entre los puntos de la malla (y el
+// propio extremo, que vale 0). Con el extremo en un punto de la malla queda igual que el extremo fijo.
+
+float SynthVoice::calcularFrontera(float semitonosNota) {
+    if (semitonosNota == 0.0f)
+        return (float)X;
+
+    // Al acortar la cuerda crece la inarmonicidad (B es proporcional a 1 / L^2) y la fundamental
+    // sube más que la longitud: se busca la longitud con la fundamental de la nota de destino en la
+    // cuerda rígida continua, w^2 = c^2 q + kappa^2 q^2 con q = (pi / L)^2
+    const float notaDestino = notaCuerda + semitonosNota;
+    double cents = 0.0;
+    if (calibracion != nullptr)
+        cents = calibracion->getCorrectionCents(notaDestino, tensionCuerda);
+
+    const double w = 2.0 * juce::MathConstants<double>::pi * 440.0 * pow(2.0, (notaDestino - 69.0) / 12.0 + cents / 1200.0);
+    const double c2 = (double)c * c;
+    const double q = 2.0 * w * w / (c2 + sqrt(c2 * c2 + 4.0 * (double)kappa * kappa * w * w));
+
+    return (float)(juce::MathConstants<double>::pi / (sqrt(q) * dx));
+}
+
+void SynthVoice::moverFrontera(float nuevaFrontera) {
+    const int xFinAnterior = xFin;
+
+    frontera = jlimit(3.0f, (float)xCapacidad, nuevaFrontera);
+    xFin = (int)ceil(frontera - 0.5f) - 1;
+
+    // Los puntos que pasan a estar dentro de la cuerda estaban en el extremo o fuera de ella: se
+    // interpolan entre el último punto actualizado y el extremo nuevo
+    for (int x = xFinAnterior + 1; x <= xFin; x++) {
+        const float peso = (frontera - x) / (frontera - xFinAnterior);
+        y[x + 1] = peso * y[xFinAnterior + 1];
+        yPrev[x + 1] = peso * yPrev[xFinAnterior + 1];
+    }
+
+    // alfa: distancia del último punto actualizado al extremo, entre 0.5 y 1.5 (con alfa cerca de 0
+    // el último punto quedaría casi desacoplado y oscilaría con una amplitud de 1 / sqrt(alfa)).
+    // Con alfa > 1 el punto xFin + 1 está dentro de la cuerda y se interpola entre xFin y el extremo.
+    // Los dos fantasmas caen entre xFin - 1 y el extremo y solo dependen de u[xFin - 1] y u[xFin]
+    const float alfaFrontera = frontera - xFin;
+
+    pesoFantasma1 = (1.0f - alfaFrontera) / alfaFrontera;
+    pesoFantasma2A = jmax(0.0f, 2.0f - 2.0f * alfaFrontera);
+    pesoFantasma2B = alfaFrontera <= 1.0f ? 2.0f * alfaFrontera - 1.0f : (2.0f - alfaFrontera) / alfaFrontera;
+
+    // La pastilla se queda en la misma fracción de la cuerda
+    const float lectura = (float)xRead * frontera / (float)X;
+    lecturaX = jmin((int)lectura, xFin);
+    lecturaFrac = lectura - (float)lecturaX;
+
+    actualizarFantasmas(y.data() + 1);
+    actualizarFantasmas(yPrev.data() + 1);
+    fronteraMovida = true;
+}
+
+void SynthVoice::actualizarFantasmas(float* u) {
+    u[xFin + 1] = -pesoFantasma1 * u[xFin];
+    u[xFin + 2] = -(pesoFantasma2A * u[xFin - 1] + pesoFantasma2B * u[xFin]);
+}
+
+// Media de x^2 con ocho sumas parciales independientes: el compilador las vectoriza sin tener que
+// reordenar una única suma en coma flotante
+
+static float potenciaMedia(const float* x, int n) {
+    float suma[8] = {};
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+        for (int j = 0; j < 8; j++)
+            suma[j] += x[i + j] * x[i + j];
+
+    for (; i < n; i++)
+        suma[0] += x[i] * x[i];
+
+    return n > 0 ? ((suma[0] + suma[4]) + (suma[1] + suma[5]) + (suma[2] + suma[6]) + (suma[3] + suma[7])) / (float)n : 0.0f;
+}
+
+// Energía discreta de la cuerda (por dt^2 / dx y salvo una constante). Sin pérdidas el esquema es
+// y+ - 2y + y- = -K y, con K = -(k1 D1 + k2 D2) simétrica, y conserva
+// H = ||y - y-||^2 + <y, K y->. La parte explícita de las pérdidas dependientes de la frecuencia,
+// 2 (1 - theta) sigma D1 (y - y-), es una pérdida centrada más un término que cambia la energía
+// cinética a <v, (1 + kv D1) v> con v = y - y-; con eso las pérdidas solo la reducen.
+
+SynthVoice::Energia SynthVoice::calcularEnergia() {
+    const float* u = y.data() + 1;
+    const float* uPrev = yPrev.data() + 1;
+
+    float cinetica = 0.0f, potencial = 0.0f;
+
+    // D1 y D2 como diferencias de diferencias: la energía de las notas graves con frecuencias de
+    // muestreo altas es mucho menor que y^2, y con y[x-1] + y[x+1] - 2y el redondeo la enmascara
+    for (int x = 1; x <= xFin; x++) {
+        const float v = u[x] - uPrev[x];
+        const float dv = (u[x + 1] - uPrev[x + 1]) - v - v + (u[x - 1] - uPrev[x - 1]);
+        const float d1 = (uPrev[x + 1] - uPrev[x]) - (uPrev[x] - uPrev[x - 1]);
+        const float d2 = (uPrev[x + 2] - uPrev[x]) - (uPrev[x] - uPrev[x - 2]);
+
+        cinetica += v * (v + kv * dv);
+        potencial -= u[x] * (k1 * d1 + k2 * d2);
+    }
+
+    return { cinetica + potencial, cinetica };
+}
+
 void SynthVoice::renderNextBlock(juce::AudioBuffer <float>& outputBuffer, int startSample, int numSamples) {
     jassert(isPrepared);    // Se comprueba que se ha llamado a la función prepareToPlay, si no, se detiene la ejecución
     
     if (!isVoiceActive())
         return;
 
-    // float stiffness;
+    HARPEJJI_TRACE_SCOPE("voz", numCuerda);
 
     synthBuffer.setSize(1, numSamples, false, false, true);
     synthBuffer.clear();
 
-    // Cálculo del término de la ecuación diferencial asociado a la rigidez
     for (int s = 0; s < synthBuffer.getNumSamples(); s++) {
-        for (int x = 1; x < X-1; x++) {
-            //if (x < 2)
-            //    stiffness = E * S * powf(K, 2) * (y[x + 2] - 4.0f * y[x + 1] + 6.0f * y[x] - 4.0f * y[x - 1]) * (powf(dt, 2) / powf(dx, 4));                  // Forward finite differences
-            //else{
-            //    if (x > X - 2)
-            //        stiffness = E * S * powf(K, 2) * (-4.0f * y[x + 1] + 6.0f * y[x] - 4.0f * y[x - 1] + y[x - 2]) / (powf(dt, 2) / powf(dx, 4));             // Backwards finite differences
-            //    else
-            //        stiffness = E * S * powf(K, 2) * (y[x + 2] - 4.0f * y[x + 1] + 6.0f * y[x] - 4.0f * y[x - 1] + y[x - 2]) * (powf(dt, 2) / powf(dx, 4));   // Central finite differences
-            //}
-            
-            // Cálculo de la posición de la cuerda en el sample siguiente
-            yNext[x] = powf(c, 2) * (y[x - 1] - 2.0f * y[x] + y[x + 1]) * (powf(dt, 2) / powf(dx, 2)) + 2 * y[x] - yPrev[x]                         //String Wave Equation
-                - 2.0f * s0 * (y[x] - yPrev[x]) * dt                                                                                                // Linear Damping
-                + 2.0f * s1 * (y[x + 1] - 2.0f * y[x] + y[x - 1] - yPrev[x + 1] + 2.0f * yPrev[x] - yPrev[x - 1]) * dt / powf(dx, 2);                // Freq. dependant damping
-                //- stiffness;                                                                                                                        // Stiffness
-        }
+        // El extremo se mueve por sub-bloques: los coeficientes no cambian y la memoria ya está reservada
+        if (s % subBloque == 0 && semitonos.isSmoothing())
+            moverFrontera(calcularFrontera(semitonos.skip(subBloque)));
 
-        synthBuffer.addSample(0, s, y[xRead]);
-        
-        c2n = alfa * powf(y[xRead], 2) + (1 - alfa) * c2n;
-        if (c2n < 0.000000005f) { 
-            numTraste = -1;
-            numCuerda = -1;
-            visualCuerda.clear();
-            clearCurrentNote();
-            return;
-        }
+        calcularSiguiente();
+
+        const float salida = y[lecturaX + 1] + lecturaFrac * (y[lecturaX + 2] - y[lecturaX + 1]);
+        synthBuffer.addSample(0, s, salida);
 
         // Se pasa la posición de la cuerda al UI
         if (s % 200 == 0)
-            visualCuerda = y;
+            visualCuerda.assign(y.begin() + 1, y.begin() + xFin + 3);
 
-        // Se guarda la posición de la cuerda actual y se actualiza
-        yPrev = y;
-        y = yNext;
+        // Se guarda la posición de la cuerda actual y se actualiza (sin copiar: se rotan los buffers)
+        std::swap(yPrev, y);
+        std::swap(y, yNext);
+    }
+
+    blockStats.puntos += (juce::int64) xFin * synthBuffer.getNumSamples();
+
+    // Una voz inestable (o con estado no finito) se apaga en este bloque y no llega al bus de salida
+    const auto energia = calcularEnergia();
+    const float umbral = 1.0e-6f * energiaNota;
+    const bool  enNodo = frontera == (float)(xFin + 1);
+    const float tolerancia = enNodo ? toleranciaEnergia : toleranciaFraccionaria;
+    const float limiteCinetica = enNodo ? maxCinetica : maxCineticaFraccionaria;
+
+    if (!std::isfinite(energia.total)
+        || energia.cinetica > limiteCinetica * energia.total + umbral
+        || (!fronteraMovida && energia.total > energiaMinima * (1.0f + tolerancia) + umbral)) {
+        blockStats.notasInestables++;
+        apagar();
+        return;
     }
 
+    energiaMinima = fronteraMovida ? energia.total : jmin(energiaMinima, energia.total);
+    fronteraMovida = false;
+
+    // Una voz retirada por el culling por enmascaramiento se funde a 0 en este bloque
+    if (retirando)
+        synthBuffer.applyGainRamp(0, 0, numSamples, 1.0f, 0.0f);
+
     // Se copian los samples del buffer de la voz al buffer de salida
     for (int channel = 0; channel < outputBuffer.getNumChannels(); channel++) {
         outputBuffer.addFrom(channel, startSample, synthBuffer, 0, 0, numSamples);
     }
+
+    samplesNota += numSamples;
+
+    if (retirando) {
+        blockStats.notasEnmascaradas++;
+        apagar();
+        return;
+    }
+
+    // Detector de silencio. La potencia de la cuerda es la que daría en la pastilla si solo sonara la
+    // fundamental (los parciales altos la sobrestiman, y la voz dura algo más); el bend cambia omega.
+    // El piso se lleva a la salida de la voz deshaciendo GAIN y el paso bajo de TONE en la
+    // fundamental, |H|^2 = 1 / (1 + tan^2(pi f / fs) / tan^2(pi fc / fs)): los parciales altos
+    // pasan todavía menos
+    const float bendNota = exp2f(semitonos.getCurrentValue() / 12.0f);
+    const float tanNota = tanf(float_Pi * jmin(0.49f, frecuenciaNota * bendNota * dt));
+    const float gananciaFundamental = gananciaSalida2 / (1.0f + tanNota * tanNota * invTanCorte2);
+    const float umbralSilencio = pisoSilencio / gananciaFundamental;
+    const float potenciaCuerda = energia.total * escalaPotencia / ((float)xFin * bendNota * bendNota);
+    const float potenciaBloque = potenciaMedia(synthBuffer.getReadPointer(0), numSamples);
+
+    nivelSalidaDb = 10.0f * log10f(jmax(potenciaBloque * gananciaFundamental, 1.0e-20f));
+
+    if (potenciaBloque < umbralSilencio && potenciaCuerda < umbralSilencio) {
+        blockStats.notasSilenciadas++;
+        apagar();
+    }
+}
+
+void SynthVoice::apagar() {
+    numTraste = -1;
+    numCuerda = -1;
+    visualCuerda.clear();
+    clearCurrentNote();
+}
+
+void SynthVoice::retire() {
+    if (isVoiceActive())
+        retirando = true;
+}
+
+// Calibración de afinación. Los modos sin(pi p x / X) son modos propios exactos del esquema
+// (extremos apoyados), así que la proyección de la cuerda sobre el primero es una sinusoide
+// amortiguada pura con la frecuencia de la fundamental simulada. Sus pasos por cero están
+// separados exactamente medio periodo aunque decaiga, y se interpolan linealmente.
+
+double SynthVoice::medirFundamental(double frequency) {
+    setInitialConditions(0.8f, frequency);
+
+    std::vector<double> modo(X + 1);
+    for (int x = 0; x <= X; x++)
+        modo[x] = sin(juce::MathConstants<double>::pi * x / X);
+
+    // Como mucho 2 periodos (y algo de margen por la dispersión)
+    const int maxSamples = (int)(2.5 / (frequency * dt)) + 16;
+
+    double anterior = 0.0;
+    double primerCruce = -1.0, ultimoCruce = -1.0;
+    int numCruces = 0;
+
+    for (int n = 0; n < maxSamples && numCruces < 5; n++) {
+        double proyeccion = 0.0;
+        for (int x = 1; x < X; x++)
+            proyeccion += modo[x] * y[x + 1];
+
+        if (n > 0 && ((anterior < 0.0 && proyeccion >= 0.0) || (anterior > 0.0 && proyeccion <= 0.0))) {
+            const double cruce = n - 1 + anterior / (anterior - proyeccion);
+            if (numCruces == 0)
+                primerCruce = cruce;
+            ultimoCruce = cruce;
+            numCruces++;
+        }
+
+        anterior = proyeccion;
+        calcularSiguiente();
+        std::swap(yPrev, y);
+        std::swap(y, yNext);
+    }
+
+    if (numCruces < 2)
+        return frequency;
+
+    const double periodo = 2.0 * (ultimoCruce - primerCruce) / (numCruces - 1);
+    return 1.0 / (periodo * dt);
+}
+
+void SynthVoice::calibratePitch(PitchCalibration& table) {
+    jassert(isPrepared);
+
+    const float tMultAnterior = tMult;
+    const auto* calibracionAnterior = calibracion;
+
+    table.clear();
+    calibracion = &table;                                   // Se mide con la corrección que se va acumulando
+
+    for (int t = 0; t < PitchCalibration::numTensions; t++) {
+        tMult = PitchCalibration::getTension(t);
+
+        for (int n = 0; n < PitchCalibration::numNotes; n++) {
+            const int nota = PitchCalibration::firstNote + n;
+            const double frecuencia = juce::MidiMessage::getMidiNoteInHertz(nota);
+
+            // La segunda pasada corrige el salto de X al acortar la cuerda
+            for (int pasada = 0; pasada < 2; pasada++)
+                table.addCents(nota, t, (float)(1200.0 * log2(frecuencia / medirFundamental(frecuencia))));
+        }
+    }
+
+    tMult = tMultAnterior;
+    calibracion = calibracionAnterior;
+    numCuerda = -1;
+    numTraste = -1;
+}
+
+void SynthVoice::setPitchCalibration(const PitchCalibration* table) {
+    calibracion = table;
+}
+
+void SynthVoice::setOutputStage(float gain, float toneCutoffHz, float silenceFloorDb) {
+    gananciaSalida2 = gain * gain;
+    pisoSilencio = powf(10.0f, silenceFloorDb / 10.0f);
+
+    // El mismo corte que usa el procesador para el filtro
+    const float sampleRate = (float)getSampleRate();
+    const float tanCorte = sampleRate > 0.0f ? tanf(float_Pi * jmin(toneCutoffHz, 0.49f * sampleRate) / sampleRate) : 0.0f;
+    invTanCorte2 = tanCorte > 0.0f ? 1.0f / (tanCorte * tanCorte) : 0.0f;
+}
+
+void SynthVoice::setRequestedString(const int* cuerda) {
+    cuerdaPedida = cuerda;
 }
 
 // Letra griega xi
@@ -227,4 +691,51 @@ int SynthVoice::getNumCuerda()
 int SynthVoice::getNumTraste()
 {
     return numTraste;
+}
+
+int SynthVoice::getNumPuntos()
+{
+    return X;
+}
+
+float SynthVoice::getFrontera()
+{
+    return frontera;
+}
+
+int SynthVoice::getMaxPuntos()
+{
+    return maxPuntos;
+}
+
+float SynthVoice::getInharmonicity()
+{
+    return B;
+}
+
+float SynthVoice::getFundamental()
+{
+    return frecuenciaNota * exp2f(semitonos.getCurrentValue() / 12.0f);
+}
+
+float SynthVoice::getOutputLevelDb()
+{
+    return nivelSalidaDb;
+}
+
+float SynthVoice::getNoteAge()
+{
+    return (float)samplesNota * dt;
+}
+
+void SynthVoice::copyVisual(std::vector<float>& dest)
+{
+    dest.assign(visualCuerda.begin(), visualCuerda.end());
+}
+
+SynthVoice::BlockStats SynthVoice::takeBlockStats()
+{
+    const auto stats = blockStats;
+    blockStats = {};
+    return stats;
 }
\ No newline at end of file
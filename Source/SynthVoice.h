@@ -12,6 +12,8 @@
 
 #include <JuceHeader.h>
 #include "SynthSound.h"
+#include "PitchCalibration.h"
+#include "Trace.h"
 
 using namespace juce;
 
@@ -24,16 +26,83 @@ public:
     void controllerMoved(int controllerNumber, int newControllerValue) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     void prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
-    void setInitialConditions(float veloc, double freq);
+    void setInitialConditions(float veloc, double freq, int cuerda = -1);   // cuerda -1: la elige la voz
     void updateParams(const float tension, const float sustain);
+
+    // Se aplican a partir de la siguiente nota
+    void setGridScale(float newLambda);             // Fracción de la malla más fina estable (0.1 - 1): menos puntos, menos CPU y más dispersión
+    void setLossTheta(float newTheta);              // Pérdidas dependientes de la frecuencia: 0 explícitas, 1 implícitas centradas (solver tridiagonal)
+    void setSpatialOrder(int newOrder);             // Precisión de la derivada espacial de la ecuación de onda: 2 (3 puntos) o 4 (5 puntos)
+
+    // Mide la fundamental simulada de cada nota y tensión con los ajustes de la siguiente nota
+    // y rellena la tabla (no es tiempo real: pisa el estado de la voz). La voz aplica la
+    // corrección en cada note on mientras la tabla exista.
+    void calibratePitch(PitchCalibration& table);
+    void setPitchCalibration(const PitchCalibration* table);
+
+    // Etapa de salida del procesador: ganancia lineal (GAIN), corte del paso bajo (TONE, Hz) y nivel
+    // a la salida del plugin (dBFS) por debajo del cual la voz se considera en silencio
+    void setOutputStage(float gain, float toneCutoffHz, float silenceFloorDb);
+    static constexpr float pisoSilencioDefecto = -90.0f;
+
+    // Cuerda pedida para el note on que se está procesando (-1: la elige la voz), p. ej. la pulsada en
+    // el diapasón del editor. La voz solo la lee en el note on (hilo de audio)
+    void setRequestedString(const int* cuerda);
+
     void renderNextBlock(juce::AudioBuffer <float>& outputBuffer, int startSample, int numSamples) override;
     
     std::vector<float> getVisual();
+    void copyVisual(std::vector<float>& dest);      // Copia sin reservar memoria (si dest tiene capacidad getMaxPuntos() + 1)
     int getNumCuerda();
     int getNumTraste();
+    int getNumPuntos();                             // Puntos de la malla de la nota actual (X)
+    float getFrontera();                            // Posición del extremo móvil en pasos dx (X sin bend ni deslizamiento)
+    int getMaxPuntos();                             // Máximo de X para la frecuencia de muestreo actual
+    float getInharmonicity();                       // Coeficiente B de la nota actual: f_n = n * f_1 * sqrt(1 + B n^2) / sqrt(1 + B)
+
+    // Para el culling por enmascaramiento del procesador (hilo de audio)
+    float getFundamental();                         // Hz, con bend y deslizamiento
+    float getOutputLevelDb();                       // Potencia del último bloque a la salida del plugin (GAIN y TONE en la fundamental)
+    float getNoteAge();                             // Segundos simulados desde el note on
+    void retire();                                  // La voz se funde a 0 en el bloque siguiente y se libera
+
+    // Contadores para ProcessorStats. Solo los usa el hilo de audio: el procesador los recoge
+    // (y se ponen a 0) después de cada bloque
+    struct BlockStats
+    {
+        int notasIniciadas = 0;
+        int notasSilenciadas = 0;                   // Apagadas por el detector de silencio
+        int notasInestables = 0;                    // Apagadas por el monitor de energía (sin llegar a la salida)
+        int notasEnmascaradas = 0;                  // Retiradas por el culling por enmascaramiento
+        juce::int64 puntos = 0;                     // Puntos de malla x samples simulados
+    };
+    BlockStats takeBlockStats();
     
+    // Pitch bend (+-rangoBend semitonos) y deslizamiento del dedo hacia el puente con el
+    // controlador ccDeslizamiento (0 - rangoDeslizamiento semitonos). Mueven el extremo x = L
+    // de la cuerda a una posición fraccionaria de la malla; dx no cambia.
+    static constexpr float rangoBend = 2.0f;
+    static constexpr int   ccDeslizamiento = 16;    // General Purpose 1
+    static constexpr float rangoDeslizamiento = 12.0f;
+
 private:
+    friend struct SynthVoiceTestAccess;             // Tests que sacan las pérdidas y la malla de sus límites
+
     float xi(float w);
+    void calcularCoeficientes();
+    float calcularDxMin();
+    void calcularSiguiente();
+    double medirFundamental(double frequency);
+    float calcularFrontera(float semitonos);
+    void moverFrontera(float nuevaFrontera);
+    void actualizarFantasmas(float* u);
+    struct Energia
+    {
+        float total = 0.0f;
+        float cinetica = 0.0f;                      // <v, (1 + kv D1) v> con v = y - y-
+    };
+    Energia calcularEnergia();
+    void apagar();                                  // Libera la voz y borra su estado visual
     
     int   numCuerda;                                // Número de cuerda que se está tocando
     int   numTraste;
@@ -41,7 +110,9 @@ private:
     float dt;                                       // Periodo de muestreo
     float dx;                                       // Distancia de muestreo espacial
     int   X;                                        // Longitud de la cuerda en pasos de muestreo L = X * dx;
+    int   maxPuntos = 0;                            // Tamaño reservado en prepareToPlay para que una nota nueva no reserve memoria
     int   xRead;                                    // Posición de lectura de la cuerda (0 - 1)
+    int   xCapacidad;                               // Puntos reservados en la nota para bajarla con el bend
     
     float s0;                                       // Parámetros de atenuación
     float s1;                                       //
@@ -51,27 +122,71 @@ private:
 
     float c0;                                       // Velocidad inicial de la cuerda
     float c;                                        // Velocidad de propagación en la cuerda
+    float kappa;                                    // Rigidez de la cuerda (m^2/s)
+    float B;                                        // Coeficiente de inarmonicidad de la nota actual
     
-    float tMult;                                    // Multiplicador de la tensión de la cuerda (controlado por el usuario)
-    float decMult;
-    //float r;                                        // Radio de la cuerda (m)
-    //float E;                                        // Young's modulus (stiffness)
-    //float S;                                        // Sección de la cuerda
-    //float K;                                        // r/2 (stiffness)
-
-    float timeDet = 1.0f;                           // Tiempo de reacción del detector (ms)
-    float alfa;                                     // Parámetro para el detector de nivel
-    float c2n;                                      // Valor del detector de nivel RMS
+    float tMult = 1.0f;                             // Multiplicador de la tensión de la cuerda (controlado por el usuario)
+    float decMult = 1.0f;
+
+    static constexpr float E = 2.0e11f;             // Módulo de Young (acero)
+    static constexpr float rho = 7850.0f;           // Densidad (acero)
+    static constexpr float Bmax = 0.02f;            // Con tensiones bajas la cuerda gruesa sería casi una barra: se limita B
+
+    // Coeficientes del esquema (se recalculan en cada nota y en stopNote). Con D1 y D2 las
+    // segundas diferencias de paso 1 y 2 (y[x-1] + y[x+1] - 2y, y[x-2] + y[x+2] - 2y):
+    // A (y+ - y) = aVel (y - y-) + a1 D1 y + a2 D2 y + b1 D1 y-
+    // Con theta = 0, A es la identidad; si no, A es tridiagonal (diagonal 1 + s0 dt + 2 theta sigma,
+    // fuera de ella -theta sigma) y se resuelve con el algoritmo de Thomas ya factorizado
+    float aVel, a1, a2, b1;
+    float k1, k2;                                   // Parte conservativa de a1, a2 (sin pérdidas ni den), para la energía
+    float kv;                                       // (1 - theta) sigma: las pérdidas explícitas cambian la energía cinética
+    float theta = 0.0f;                             // El de la nota actual
+    float thetaSiguiente = 0.0f;                    // El de setLossTheta
+    int   orden = 2;                                // El de la nota actual
+    int   ordenSiguiente = 2;                       // El de setSpatialOrder
+    float aFuera;                                   // -theta sigma
+    std::vector<float> thomasC;                     // Factorización de A: c'[x] y 1 / (pivote de la fila x)
+    std::vector<float> thomasInv;                   //
+
+    // Monitor de energía: al final de cada bloque se calcula la energía discreta de la cuerda, que con
+    // pérdidas no puede crecer. Si supera su mínimo (más que el ruido de redondeo del estado en float,
+    // ~1e-3) o no es finita, la voz se apaga sin llegar a sumar ese bloque a la salida. Con el mínimo
+    // y no el bloque anterior, un crecimiento lento se detecta igual con bloques cortos.
+    // Fuera del límite de estabilidad la energía deja de ser definida positiva y puede mantenerse
+    // mientras la cuerda explota: entonces la cinética crece muy por encima de la total.
+    // Con el extremo entre dos puntos de la malla la energía solo se conserva aproximadamente (los
+    // fantasmas interpolados no son simétricos) y los límites son más anchos
+    static constexpr float toleranciaEnergia = 1.0e-2f;
+    static constexpr float maxCinetica = 4.0f;      // Cinética / total: ~1 en los modos de la cuerda
+    static constexpr float toleranciaFraccionaria = 0.1f;
+    static constexpr float maxCineticaFraccionaria = 8.0f;
+    float energiaMinima = 0.0f;
+    float energiaNota = 0.0f;                       // La del note on (para el umbral absoluto cuando queda poca)
+    bool  fronteraMovida = false;                   // El extremo móvil hace trabajo sobre la cuerda: ese bloque no se compara
+
+    // Detector de silencio, una vez por bloque: la voz se libera cuando la potencia media del bloque de
+    // salida y la de la cuerda entera (estimada con su energía) quedan por debajo del piso, llevado a
+    // la salida de la voz. Solo con la salida, un bloque corto en un paso por cero o una pastilla cerca
+    // del nodo de un modo apagarían una cuerda que todavía suena
+    float pisoSilencio = 1.0e-9f;                   // Potencia del piso a la salida del plugin (-90 dBFS)
+    float gananciaSalida2 = 1.0f;                   // GAIN^2
+    float invTanCorte2 = 0.0f;                      // 1 / tan^2(pi fc / fs) del paso bajo de TONE (0: sin filtro)
+    float frecuenciaNota;                           // Hz, sin bend
+    float escalaPotencia;                           // Energía / xFin -> potencia en la pastilla (nota sin bend)
+    float nivelSalidaDb = 0.0f;                     // El del último bloque, a la salida del plugin
+    juce::int64 samplesNota = 0;
+    bool  retirando = false;                        // retire(): fundido a 0 en el bloque siguiente
 
     // Se establecen las características de las 16 cuerdas (características medidas/calculadas usando cuerdas reales)
 
-    float L_esc = 1;                           // Longitud de escala 27" = 68.58 cm
+    float L_esc = 1;                           // Longitud de escala del modelo
+    float L_real = 0.6858f;                    // Longitud de escala 27" = 68.58 cm (para la rigidez)
 
-    float Strings[2][16] = {
+    float Strings[3][16] = {
         // {   89.7114f, 100.6977f, 113.0293f, 126.8711f, 142.4077f, 159.8476f, 179.8476f, 201.3948f, 226.0589f, 253.7419f, 284.8155f, 319.6953f, 358.8462f, 402.7907f, 452.1178f, 507.4838f },    // Velocidad del sonido en la cuerda
-        // {  1.626e-3f, 1.422e-3f, 1.219e-3f, 1.016e-3f, 8.636e-4f,  7.62e-4f, 6.604e-4f, 5.588e-4f, 4.572e-4f, 4.064e-4f, 3.556e-4f, 3.048e-4f, 3.048e-4f,  2.54e-4f,  2.29e-4f,  2.03e-4f },    // Diámetro
         {     65.4f,    73.4f,    82.4f,    92.5f,   103.8f,   116.5f,  130.8f,   146.8f,   164.8f,   185.0f,   207.6f,   233.0f,   261.6f,   293.6f,   329.6f,   369.9f },    // Frecuencia min
-        {    185.0f,   207.5f,   233.0f,   261.6f,   293.6f,   329.6f,  370.0f,   415.3f,   466.1f,   523.2f,   587.3f,   659.2f,   740.0f,   830.6f,   932.3f,  1046.5f }     // Frecuencia max
+        {    185.0f,   207.5f,   233.0f,   261.6f,   293.6f,   329.6f,  370.0f,   415.3f,   466.1f,   523.2f,   587.3f,   659.2f,   740.0f,   830.6f,   932.3f,  1046.5f },    // Frecuencia max
+        {  1.626e-3f, 1.422e-3f, 1.219e-3f, 1.016e-3f, 8.636e-4f,  7.62e-4f, 6.604e-4f, 5.588e-4f, 4.572e-4f, 4.064e-4f, 3.556e-4f, 3.048e-4f, 3.048e-4f,  2.54e-4f,  2.29e-4f,  2.03e-4f }     // Diámetro (m)
     };
 
     float loss[2][2] = {
@@ -82,9 +197,29 @@ private:
     int   pos = 1;                                  // Posición en la que se toca la cuerda (Posición 1: trastes 1-6, posición 2: trastes 7-13...)
     float ctr = 0.6;                               // Punto de máxima velocidad inicial
     float read = 0.8f;                              // Posición de lectura de la cuerda 0-1 (0.7 Ok)
-    float lambda = 1;                               // Estabilidad ¡¡Ejemplo lambda = 1!!
+    float lambda = 1;                               // Fracción de la malla más fina estable (1: dx en el límite de estabilidad)
+
+    // Extremo móvil: está en x = frontera (en pasos dx, entre xFin + 0.5 y xFin + 1.5) y se actualizan
+    // los puntos 1 - xFin. Los puntos fantasma xFin + 1 y xFin + 2 son la reflexión impar de la cuerda
+    // respecto al extremo, interpolada linealmente: u[xFin + 1] = -pesoFantasma1 u[xFin] y
+    // u[xFin + 2] = -(pesoFantasma2A u[xFin - 1] + pesoFantasma2B u[xFin])
+    static constexpr int subBloque = 32;            // Samples entre actualizaciones del extremo
+    float frontera;
+    int   xFin;
+    float pesoFantasma1, pesoFantasma2A, pesoFantasma2B;
+    int   lecturaX;                                 // La pastilla se mueve con el extremo (a la misma
+    float lecturaFrac;                              // fracción de la cuerda) y se interpola
+
+    float bend = 0.0f;                              // Semitonos del pitch wheel
+    float deslizamiento = 0.0f;                     // Semitonos del controlador de deslizamiento
+    juce::SmoothedValue<float> semitonos;           // bend + deslizamiento, con rampa para que no haya saltos
+    float notaCuerda;                               // Nota MIDI (fraccionaria) y tensión del note on,
+    float tensionCuerda;                            // para corregir la afinación con la calibración
 
     std::vector<float> v0;
+    // Posiciones de la cuerda con puntos fantasma en los extremos: y[x + 1] es el punto x (0 - xCapacidad),
+    // y[0] = -y[2] y, sin bend, y[X + 1] = 0 e y[X + 2] = -y[X] (extremos apoyados, los necesita el
+    // término de rigidez)
     std::vector<float> yNext;
     std::vector<float> yPrev;
     std::vector<float> y;
@@ -94,4 +229,9 @@ private:
     juce::AudioBuffer<float> synthBuffer;
 
     bool isPrepared = false;
+
+    const PitchCalibration* calibracion = nullptr;
+    const int* cuerdaPedida = nullptr;
+
+    BlockStats blockStats;
 };
\ No newline at end of file
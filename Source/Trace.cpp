@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+    Trace.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "Trace.h"
+#include "RealtimeCheck.h"
+
+namespace trace
+{
+    namespace detail
+    {
+        std::atomic<bool> activa { false };
+    }
+
+    namespace
+    {
+        struct Evento
+        {
+            const char* nombre;
+            int arg;
+            juce::int64 inicio;
+            juce::int64 fin;
+        };
+
+        // Buffer circular SPSC de un hilo: productor el hilo que traza, consumidor el escritor
+        struct BufferHilo
+        {
+            static constexpr int capacidad = 1 << 14;
+
+            juce::AbstractFifo fifo { capacidad };
+            std::array<Evento, capacidad> eventos;
+            std::atomic<juce::uint64> perdidos { 0 };      // Eventos descartados con el buffer lleno
+
+            // libre -> reservado (un hilo lo ha cogido y está rellenando el nombre) -> enUso ->
+            // terminado (el hilo ha salido) -> libre, cuando el escritor ha vaciado lo que quedaba
+            enum Estado { libre, reservado, enUso, terminado };
+            std::atomic<int> estado { libre };
+
+            int tid = 0;                                    // Se asigna al cogerlo: un hilo nuevo no hereda el del anterior
+            const char* nombreFijo = nullptr;
+            juce::String nombreHilo;
+            bool nombreEscrito = false;                     // Solo lo usa el escritor
+
+            void push(const Evento& e) noexcept
+            {
+                int start1, size1, start2, size2;
+                fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+                if (size1 + size2 == 0) {
+                    perdidos.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                eventos[(size_t) (size1 > 0 ? start1 : start2)] = e;
+                fifo.finishedWrite(1);
+            }
+        };
+
+        constexpr int maxHilos = 32;
+
+        struct Buffers
+        {
+            std::array<BufferHilo, maxHilos> hilos;
+            std::atomic<int> siguienteTid { 1 };
+            std::atomic<juce::uint64> perdidosSinBuffer { 0 };  // Eventos de hilos que no encontraron buffer libre
+        };
+
+        // Se crea en el primer start() y no se libera nunca: un hilo puede seguir
+        // dentro de un scope cuando se para la traza
+        std::atomic<Buffers*> buffers { nullptr };
+
+        thread_local BufferHilo* bufferHilo = nullptr;
+
+        // Devuelve el buffer cuando termina el hilo, para que lo reutilice otro (un host puede
+        // crear un hilo de audio nuevo cada vez que se reinicia el dispositivo). Registrar el
+        // destructor de un thread_local reserva memoria una vez por hilo; solo pasa con la traza
+        // activa, al coger el buffer
+        struct RegistroHilo
+        {
+            BufferHilo* buffer = nullptr;
+
+            ~RegistroHilo()
+            {
+                if (buffer != nullptr)
+                    buffer->estado.store(BufferHilo::terminado, std::memory_order_release);
+
+                bufferHilo = nullptr;
+            }
+        };
+
+        BufferHilo* getBufferHilo() noexcept
+        {
+            if (bufferHilo != nullptr)
+                return bufferHilo;
+
+            auto* b = buffers.load(std::memory_order_acquire);
+            if (b == nullptr)
+                return nullptr;
+
+            BufferHilo* libre = nullptr;
+
+            for (auto& h : b->hilos) {
+                int esperado = BufferHilo::libre;
+                if (h.estado.load(std::memory_order_relaxed) == esperado
+                     && h.estado.compare_exchange_strong(esperado, BufferHilo::reservado, std::memory_order_acquire)) {
+                    libre = &h;
+                    break;
+                }
+            }
+
+            if (libre == nullptr) {
+                b->perdidosSinBuffer.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            auto& buf = *libre;
+            buf.tid = b->siguienteTid.fetch_add(1);
+
+            // En el hilo de audio no se puede preguntar a juce::Thread (reserva memoria la primera vez)
+            if (rtcheck::isAudioThread())
+                buf.nombreFijo = "Audio";
+            else if (auto* t = juce::Thread::getCurrentThread())
+                buf.nombreHilo = t->getThreadName();
+
+            buf.estado.store(BufferHilo::enUso, std::memory_order_release);
+
+            thread_local RegistroHilo registro;
+            registro.buffer = &buf;
+
+            bufferHilo = &buf;
+            return bufferHilo;
+        }
+
+        //==============================================================================
+        class Escritor : public juce::Thread
+        {
+        public:
+            explicit Escritor(std::unique_ptr<juce::FileOutputStream> s)
+                : juce::Thread("Harpejji trace writer"), salida(std::move(s)),
+                  origen(juce::Time::getHighResolutionTicks()),
+                  usPorTick(1.0e6 / (double) juce::Time::getHighResolutionTicksPerSecond())
+            {
+                *salida << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Harpejji\"}}";
+                startThread(3);
+            }
+
+            ~Escritor() override
+            {
+                stopThread(2000);
+                vaciar();
+
+                juce::uint64 perdidos = 0, sinBuffer = 0;
+                if (auto* b = buffers.load(std::memory_order_acquire)) {
+                    for (auto& h : b->hilos)
+                        perdidos += h.perdidos.exchange(0);
+                    sinBuffer = b->perdidosSinBuffer.exchange(0);
+                }
+
+                *salida << "\n],\"otherData\":{\"eventosPerdidos\":" << juce::String((juce::int64) perdidos)
+                        << ",\"eventosSinBuffer\":" << juce::String((juce::int64) sinBuffer) << "}}\n";
+                salida->flush();
+            }
+
+            void run() override
+            {
+                while (!threadShouldExit()) {
+                    vaciar();
+                    wait(20);
+                }
+            }
+
+        private:
+            void vaciar()
+            {
+                auto* b = buffers.load(std::memory_order_acquire);
+                if (b == nullptr)
+                    return;
+
+                for (auto& buf : b->hilos) {
+                    const int estado = buf.estado.load(std::memory_order_acquire);
+                    if (estado != BufferHilo::enUso && estado != BufferHilo::terminado)
+                        continue;
+
+                    const int tid = buf.tid;
+
+                    if (!buf.nombreEscrito) {
+                        const juce::String nombre = buf.nombreFijo != nullptr ? juce::String(buf.nombreFijo)
+                                                  : buf.nombreHilo.isNotEmpty() ? buf.nombreHilo
+                                                  : "Hilo " + juce::String(tid);
+                        *salida << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                                << ",\"args\":{\"name\":" << juce::JSON::toString(nombre) << "}}";
+                        buf.nombreEscrito = true;
+                    }
+
+                    int start1, size1, start2, size2;
+                    buf.fifo.prepareToRead(buf.fifo.getNumReady(), start1, size1, start2, size2);
+
+                    for (int i = start1; i < start1 + size1; i++)
+                        escribir(buf.eventos[(size_t) i], tid);
+                    for (int i = start2; i < start2 + size2; i++)
+                        escribir(buf.eventos[(size_t) i], tid);
+
+                    buf.fifo.finishedRead(size1 + size2);
+
+                    // El hilo ya no escribe: se deja libre para otro
+                    if (estado == BufferHilo::terminado) {
+                        buf.nombreFijo = nullptr;
+                        buf.nombreHilo = {};
+                        buf.nombreEscrito = false;
+                        buf.estado.store(BufferHilo::libre, std::memory_order_release);
+                    }
+                }
+
+                salida->flush();
+            }
+
+            void escribir(const Evento& e, int tid)
+            {
+                if (e.inicio < origen)                      // Restos de una traza anterior
+                    return;
+
+                *salida << ",\n{\"name\":\"" << e.nombre << "\",\"cat\":\"audio\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                        << ",\"ts\":" << juce::String((double) (e.inicio - origen) * usPorTick, 3)
+                        << ",\"dur\":" << juce::String((double) (e.fin - e.inicio) * usPorTick, 3);
+
+                if (e.arg >= 0)
+                    *salida << ",\"args\":{\"arg\":" << e.arg << "}";
+
+                *salida << "}";
+            }
+
+            std::unique_ptr<juce::FileOutputStream> salida;
+            const juce::int64 origen;
+            const double usPorTick;
+        };
+
+        std::unique_ptr<Escritor> escritor;             // Solo se toca desde el hilo de mensajes
+    }
+
+    //==============================================================================
+    namespace detail
+    {
+        void record(const char* name, int arg, juce::int64 startTicks, juce::int64 endTicks) noexcept
+        {
+            if (auto* buf = getBufferHilo())
+                buf->push({ name, arg, startTicks, endTicks });
+        }
+    }
+
+    bool start(const juce::File& file)
+    {
+        if (escritor != nullptr)
+            return false;
+
+        file.deleteFile();
+        auto salida = std::make_unique<juce::FileOutputStream>(file);
+        if (!salida->openedOk())
+            return false;
+
+        if (buffers.load() == nullptr)
+            buffers.store(new Buffers(), std::memory_order_release);
+
+        // Los hilos que ya tienen buffer lo conservan; se marca su nombre como pendiente
+        // para que aparezca en el fichero nuevo
+        for (auto& h : buffers.load()->hilos)
+            h.nombreEscrito = false;
+
+        escritor = std::make_unique<Escritor>(std::move(salida));
+        detail::activa.store(true);
+        return true;
+    }
+
+    void stop()
+    {
+        detail::activa.store(false);
+        escritor.reset();
+    }
+}
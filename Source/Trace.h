@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    Trace.h
+    Created: 19 Oct 2026
+
+    Trazas del hilo de audio en formato Chrome trace (chrome://tracing o
+    ui.perfetto.dev). Cada HARPEJJI_TRACE_SCOPE guarda un evento completo
+    (inicio y duración) en el buffer circular del hilo que lo ejecuta; un hilo
+    de fondo vacía los buffers al fichero JSON.
+
+    Con la traza parada cada scope cuesta una lectura atómica relajada. Con
+    -DHARPEJJI_TRACE=0 los scopes desaparecen del todo. El procesador arranca
+    la traza si existe la variable de entorno HARPEJJI_TRACE=<fichero.json>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef HARPEJJI_TRACE
+ #define HARPEJJI_TRACE 1
+#endif
+
+namespace trace
+{
+    // Hilo de mensajes. start() devuelve false si ya hay una traza en curso o
+    // si no se puede crear el fichero.
+    bool start(const juce::File& file);
+    void stop();
+
+    namespace detail
+    {
+        extern std::atomic<bool> activa;
+        void record(const char* name, int arg, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+    }
+
+    inline bool isEnabled() noexcept
+    {
+        return detail::activa.load(std::memory_order_relaxed);
+    }
+
+    // 'name' tiene que ser un literal (solo se guarda el puntero). 'arg' se
+    // exporta en args si es >= 0 (p. ej. la cuerda que renderiza una voz).
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name, int arg = -1) noexcept
+        {
+            if (isEnabled()) {
+                nombre = name;
+                argumento = arg;
+                inicio = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        ~Scope() noexcept
+        {
+            if (nombre != nullptr)
+                detail::record(nombre, argumento, inicio, juce::Time::getHighResolutionTicks());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* nombre = nullptr;
+        int argumento = -1;
+        juce::int64 inicio = 0;
+    };
+}
+
+#if HARPEJJI_TRACE
+ #define HARPEJJI_TRACE_SCOPE(...) const trace::Scope JUCE_JOIN_MACRO(traceScope_, __LINE__) (__VA_ARGS__)
+#else
+ #define HARPEJJI_TRACE_SCOPE(...)
+#endif
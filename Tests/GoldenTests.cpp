@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    GoldenTests.cpp
+    Created: 19 Oct 2026
+
+    Regresión de audio: secuencias MIDI fijas renderizadas con el procesador y
+    comparadas con renders de referencia guardados en Tests/Golden. Cualquier
+    optimización de SynthVoice tiene que mantener el sonido dentro de las
+    tolerancias (error por sample, error espectral y error de pitch).
+
+    Las referencias se (re)generan con: harpejji_tests --update-golden
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+
+namespace
+{
+    struct Secuencia
+    {
+        const char* nombre;
+        std::vector<test::Nota> notas;
+        int notaPitch;                              // Nota cuyo pitch se compara (-1 si no aplica)
+    };
+
+    std::vector<Secuencia> getSecuencias()
+    {
+        return {
+            { "single_c4",  { { 0.0, 1.5, 60, 0.8f } }, 60 },
+            { "single_c2",  { { 0.0, 1.5, 36, 0.8f } }, 36 },
+            { "single_c6",  { { 0.0, 1.5, 84, 0.8f } }, 84 },
+            { "soft_g3",    { { 0.0, 1.5, 55, 0.2f } }, 55 },
+            { "arpeggio",   { { 0.0, 0.4, 48, 0.7f }, { 0.25, 0.4, 52, 0.7f }, { 0.5, 0.4, 55, 0.7f },
+                              { 0.75, 0.4, 60, 0.7f }, { 1.0, 0.8, 64, 0.9f } }, -1 },
+            { "chord6",     { { 0.0, 1.5, 40, 0.8f }, { 0.0, 1.5, 47, 0.8f }, { 0.0, 1.5, 52, 0.8f },
+                              { 0.0, 1.5, 56, 0.8f }, { 0.0, 1.5, 59, 0.8f }, { 0.0, 1.5, 64, 0.8f } }, -1 },
+        };
+    }
+}
+
+class GoldenTests : public juce::UnitTest
+{
+public:
+    GoldenTests() : juce::UnitTest("Golden audio", "Harpejji") {}
+
+    void runTest() override
+    {
+        const auto& config = test::getConfig();
+
+        test::Render r;
+        r.sampleRate = 48000.0;
+        r.blockSize = 256;
+        r.segundos = 2.0;
+
+        for (const auto& sec : getSecuencias()) {
+            beginTest(sec.nombre);
+
+            const auto audio = test::render(sec.notas, r);
+            expect(test::allFinite(audio), "salida no finita");
+
+            const auto fichero = config.goldenDir.getChildFile(juce::String(sec.nombre) + ".wav");
+
+            if (config.updateGolden) {
+                expect(test::writeWav(fichero, audio, r.sampleRate), "no se puede escribir " + fichero.getFullPathName());
+                logMessage("referencia actualizada: " + fichero.getFullPathName());
+                continue;
+            }
+
+            juce::AudioBuffer<float> referencia;
+            double srReferencia = 0.0;
+
+            // Sin referencia el caso se omite (se avisa en el log) salvo con --require-golden,
+            // que lo trata como un fallo para no dar por buena una comparación que no se ha hecho
+            if (!fichero.existsAsFile()) {
+                if (config.requireGolden)
+                    expect(false, "falta la referencia " + fichero.getFullPathName() + " (generar con --update-golden)");
+                else
+                    logMessage("OMITIDO: falta la referencia " + fichero.getFullPathName() + " (generar con --update-golden)");
+                continue;
+            }
+
+            expect(test::readWav(fichero, referencia, srReferencia), "no se puede leer " + fichero.getFullPathName());
+            expectEquals(srReferencia, r.sampleRate);
+            expectEquals(referencia.getNumSamples(), audio.getNumSamples());
+
+            if (referencia.getNumSamples() != audio.getNumSamples())
+                continue;
+
+            // Error por sample, relativo al pico de la referencia
+            const float pico = juce::jmax(1.0e-9f, referencia.getMagnitude(0, 0, referencia.getNumSamples()));
+            float errorMax = 0.0f;
+            for (int s = 0; s < audio.getNumSamples(); s++)
+                errorMax = juce::jmax(errorMax, std::abs(audio.getSample(0, s) - referencia.getSample(0, s)));
+
+            expectLessOrEqual((double) (errorMax / pico), config.sampleTolerance, "error por sample");
+
+            // Error espectral medio en los bins con energía (a menos de 90 dB del máximo)
+            const auto espectro = test::averageSpectrumDb(audio, 13);
+            const auto espectroRef = test::averageSpectrumDb(referencia, 13);
+            const float maxRef = *std::max_element(espectroRef.begin(), espectroRef.end());
+
+            double errorDb = 0.0;
+            int numBins = 0;
+            for (size_t b = 0; b < espectro.size(); b++)
+                if (espectroRef[b] > maxRef - 90.0f) {
+                    errorDb += std::abs(espectro[b] - espectroRef[b]);
+                    numBins++;
+                }
+
+            expectLessOrEqual(errorDb / juce::jmax(1, numBins), config.spectralToleranceDb, "error espectral (dB)");
+
+            // Error de pitch de la fundamental
+            if (sec.notaPitch >= 0) {
+                const double f0 = juce::MidiMessage::getMidiNoteInHertz(sec.notaPitch);
+                const double pitch = test::estimatePitch(audio, r.sampleRate, 0.8 * f0, 1.25 * f0);
+                const double pitchRef = test::estimatePitch(referencia, r.sampleRate, 0.8 * f0, 1.25 * f0);
+
+                expectLessOrEqual(std::abs(test::cents(pitch, pitchRef)), config.pitchToleranceCents, "error de pitch (cents)");
+            }
+        }
+    }
+};
+
+static GoldenTests goldenTests;
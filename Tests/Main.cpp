@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    Main.cpp (harpejji_tests)
+    Created: 19 Oct 2026
+
+    harpejji_tests [--update-golden] [--require-golden] [--golden-dir dir] [--quick]
+                   [--update-calibration]
+                   [--sample-tol 1e-4] [--spectral-tol-db 0.5] [--pitch-tol-cents 1]
+                   [--test "nombre"]
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const juce::ArgumentList args(argc, argv);
+    auto& config = test::getConfig();
+
+    config.goldenDir = args.containsOption("--golden-dir")
+                     ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--golden-dir"))
+                     : juce::File(HARPEJJI_GOLDEN_DIR);
+    config.updateGolden = args.containsOption("--update-golden");
+    config.requireGolden = args.containsOption("--require-golden");
+    config.quick = args.containsOption("--quick");
+    config.calibrationFile = juce::File(HARPEJJI_SOURCE_DIR).getChildFile("PitchCalibrationTables.h");
+    config.updateCalibration = args.containsOption("--update-calibration");
+
+    if (args.containsOption("--sample-tol"))      config.sampleTolerance = args.getValueForOption("--sample-tol").getDoubleValue();
+    if (args.containsOption("--spectral-tol-db")) config.spectralToleranceDb = args.getValueForOption("--spectral-tol-db").getDoubleValue();
+    if (args.containsOption("--pitch-tol-cents")) config.pitchToleranceCents = args.getValueForOption("--pitch-tol-cents").getDoubleValue();
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (args.containsOption("--test")) {
+        const auto nombre = args.getValueForOption("--test");
+        for (auto* t : juce::UnitTest::getTestsInCategory("Harpejji"))
+            if (t->getName() == nombre)
+                runner.runTests({ t });
+    }
+    else
+        runner.runTestsInCategory("Harpejji");
+
+    for (int i = 0; i < runner.getNumResults(); i++)
+        if (runner.getResult(i)->failures > 0)
+            return 1;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    MaskingCullingTests.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "MaskingCulling.h"
+
+class MaskingCullingTests : public juce::UnitTest
+{
+public:
+    MaskingCullingTests() : juce::UnitTest("Culling por enmascaramiento", "Harpejji") {}
+
+    void runTest() override
+    {
+        using Voz = MaskingCulling::Voz;
+
+        auto retiradas = [] (float agresividad, std::vector<Voz> voces) {
+            MaskingCulling culling;
+            culling.setAggressiveness(agresividad);
+
+            bool retirar[MaskingCulling::maxVoces] = {};
+            culling.process(voces.data(), (int) voces.size(), retirar);
+            return std::vector<bool>(retirar, retirar + voces.size());
+        };
+
+        const Voz fuerte { true, -20.0f, 261.6f, 1.0e-4f, 1.0f };
+
+        beginTest("Una cola débil junto a una nota fuerte");
+        {
+            const Voz debil { true, -60.0f, 293.7f, 1.0e-4f, 1.0f };
+
+            expect(!retiradas(0.0f, { fuerte, debil })[1], "retirada con el culling desactivado");
+            expect(retiradas(0.5f, { fuerte, debil })[1], "no se retira");
+            expect(!retiradas(0.5f, { fuerte, debil })[0], "se retira la voz fuerte");
+
+            auto joven = debil;
+            joven.edad = 0.5f * MaskingCulling::edadMinima;
+            expect(!retiradas(1.0f, { fuerte, joven })[1], "se retira una nota en el ataque");
+        }
+
+        beginTest("Solo enmascaran los parciales cercanos");
+        {
+            // Una nota aguda no tapa a una grave (la dispersión cae deprisa hacia los graves),
+            // y una grave no tapa a una aguda lejos de sus parciales
+            const Voz grave { true, -45.0f, 65.4f, 1.0e-4f, 1.0f };
+            const Voz aguda { true, -45.0f, 1046.5f, 1.0e-3f, 1.0f };
+            const Voz fuerteGrave { true, -20.0f, 65.4f, 1.0e-4f, 1.0f };
+            const Voz fuerteAguda { true, -20.0f, 1046.5f, 1.0e-3f, 1.0f };
+
+            expect(!retiradas(1.0f, { fuerteAguda, grave })[1], "una nota aguda tapa a una grave");
+            expect(!retiradas(1.0f, { fuerteGrave, aguda })[1], "una nota grave tapa a una aguda lejana");
+            expect(retiradas(1.0f, { fuerteGrave, grave })[1], "una nota no tapa a otra igual más débil");
+        }
+
+        beginTest("La agresividad retira cada vez más voces");
+        {
+            juce::Random random(1234);
+            std::vector<Voz> voces;
+
+            for (int i = 0; i < MaskingCulling::maxVoces; i++)
+                voces.push_back({ true, -20.0f - 60.0f * random.nextFloat(), 65.4f * std::exp2(4.0f * random.nextFloat()), 1.0e-4f, 1.0f });
+
+            int anterior = 0;
+
+            for (float agresividad : { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f }) {
+                const auto r = retiradas(agresividad, voces);
+                const int n = (int) std::count(r.begin(), r.end(), true);
+
+                logMessage("agresividad " + juce::String(agresividad, 2) + ": " + juce::String(n) + " de " + juce::String((int) voces.size()) + " voces retiradas");
+                expectGreaterOrEqual(n, anterior);
+                expect(n < (int) voces.size(), "se retiran todas las voces");
+                anterior = n;
+            }
+        }
+
+        beginTest("El procesador retira la cola enmascarada");
+        {
+            auto tocar = [] (float agresividad) {
+                SynthAudioProcessor processor;
+                processor.setMaskingCulling(agresividad);
+                processor.setRateAndBufferSizeDetails(48000.0, 256);
+                processor.prepareToPlay(48000.0, 256);
+
+                juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), 256);
+                juce::MidiBuffer midi;
+
+                for (int nota : { 48, 52, 55, 60 })
+                    midi.addEvent(juce::MidiMessage::noteOn(1, nota, 1.0f), 0);
+                midi.addEvent(juce::MidiMessage::noteOn(1, 62, 0.02f), 0);
+
+                bool finita = true;
+
+                for (int b = 0; b < 48000 / 256; b++) {
+                    buffer.clear();
+                    processor.processBlock(buffer, midi);
+                    midi.clear();
+
+                    for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+                        for (int s = 0; s < buffer.getNumSamples(); s++)
+                            finita = finita && std::isfinite(buffer.getSample(ch, s));
+                }
+
+                processor.releaseResources();
+                return std::make_pair(processor.getStats().getSnapshot().voicesMasked, finita);
+            };
+
+            const auto sinCulling = tocar(0.0f);
+            const auto conCulling = tocar(1.0f);
+
+            expectEquals((int) sinCulling.first, 0);
+            expectEquals((int) conCulling.first, 1);
+            expect(sinCulling.second && conCulling.second, "salida no finita");
+        }
+    }
+};
+
+static MaskingCullingTests maskingCullingTests;
@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    ProcessorTests.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+class ProcessorTests : public juce::UnitTest
+{
+public:
+    ProcessorTests() : juce::UnitTest("SynthAudioProcessor", "Harpejji") {}
+
+    void runTest() override
+    {
+        beginTest("Una nota produce sonido finito");
+
+        const double sampleRate = 48000.0;
+        const int blockSize = 256;
+
+        SynthAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
+
+        float pico = 0.0f;
+        bool finito = true;
+
+        for (int b = 0; b < 100; b++) {
+            processor.processBlock(buffer, midi);
+            midi.clear();
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+                for (int s = 0; s < blockSize; s++) {
+                    const float x = buffer.getSample(ch, s);
+                    finito = finito && std::isfinite(x);
+                    pico = juce::jmax(pico, std::abs(x));
+                }
+        }
+
+        expect(finito);
+        expect(pico > 0.0f);
+
+        beginTest("Estadísticas por bloque");
+
+        SynthAudioProcessor nuevo;                  // Con todas las voces libres
+        nuevo.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        nuevo.prepareToPlay(sampleRate, blockSize);
+
+        const auto antes = nuevo.getStats().getSnapshot();
+
+        // 8 notas a la vez con 6 voces y sin robo de voces: se pierden 2, más una fuera de rango
+        for (int i = 0; i < 8; i++)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 40 + 3 * i, 0.8f), 0);
+        midi.addEvent(juce::MidiMessage::noteOn(1, 100, 0.8f), 0);
+
+        nuevo.processBlock(buffer, midi);
+        midi.clear();
+
+        const auto d = nuevo.getStats().getSnapshot().since(antes);
+
+        expectEquals((int) d.numBlocks, 1);
+        expectEquals((int) d.numSamples, blockSize);
+        expectEquals((int) d.noteOns, 9);
+        expectEquals((int) d.droppedNotes, 3);
+        expectEquals(nuevo.getStats().getSnapshot().activeVoices, 6);
+        expect(d.gridPoints > 0);
+        expect(d.getPercentileUs(0.5f) > 0.0f);
+
+        beginTest("Diapasón del editor: cuerda, traste y latencia");
+
+        // Una pulsación en el editor suena en la cuerda y el traste pulsados (la misma nota está en
+        // varias cuerdas) y empieza como mucho un bloque después
+        SynthAudioProcessor tocado;
+        tocado.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        tocado.prepareToPlay(sampleRate, blockSize);
+
+        SynthAudioProcessorEditor editor(tocado);
+        const float r = 1.0f - 1.0f / 17.817f;      // Relación entre trastes del editor
+        const double maxLatenciaMs = 1000.0 * blockSize / sampleRate + 0.1;
+
+        for (int cuerda : { 0, 1, 5, 10, 15 })
+            for (int traste : { 1, 3, 4, 6, 8 }) {
+                const juce::Point<float> posicion((cuerda + 0.5f) * editor.getWidth() / 16.0f, 908.0f * std::pow(r, traste - 0.5f));
+                const auto p = editor.getFretAt(posicion);
+                const auto caso = "cuerda " + juce::String(cuerda) + " traste " + juce::String(traste);
+
+                expectEquals(p.cuerda, cuerda, caso);
+                expectEquals(p.traste, traste, caso);
+                if (p.nota < 0)
+                    continue;
+
+                tocado.postNoteOn(p.nota, 0.8f, p.cuerda);
+                tocado.processBlock(buffer, midi);
+                expectLessOrEqual((double) tocado.getNoteLatencyMs(), maxLatenciaMs, caso);
+
+                // El estado de las cuerdas que dibuja el editor se copia al principio del bloque
+                tocado.processBlock(buffer, midi);
+                const auto cuerdas = tocado.getNumCuerda();
+                const auto trastes = tocado.getNumTraste();
+
+                bool encontrada = false;
+                for (size_t i = 0; i < cuerdas.size() && i < trastes.size(); i++)
+                    encontrada = encontrada || (cuerdas[i] == cuerda && trastes[i] == traste);
+
+                expect(encontrada, "no suena en la " + caso);
+
+                // Se suelta y se espera a que la voz quede libre (6 voces sin robo de voces)
+                tocado.postNoteOff(p.nota);
+                for (int b = 0; b < (int) sampleRate / blockSize && !tocado.getNumCuerda().empty(); b++)
+                    tocado.processBlock(buffer, midi);
+            }
+
+        expectGreaterThan(tocado.getNoteLatencyMs(), 0.0f);
+
+        beginTest("Cuerda pedida: va con cada nota del editor");
+        {
+            // La cuerda viaja con el note on de la cola: un note off de la misma nota en el mismo
+            // bloque no la borra y el MIDI del host no la hereda
+            SynthAudioProcessor pedida;
+            pedida.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            pedida.prepareToPlay(sampleRate, blockSize);
+
+            const int nota = 53;
+            auto soltarTodo = [&]
+            {
+                for (int b = 0; b < (int) sampleRate / blockSize && !pedida.getNumCuerda().empty(); b++)
+                    pedida.processBlock(buffer, midi);
+            };
+            auto cuenta = [&](int cuerda)
+            {
+                const auto cuerdas = pedida.getNumCuerda();
+                return (int) std::count(cuerdas.begin(), cuerdas.end(), cuerda);
+            };
+
+            // Cuerda que elige la voz para la nota del host
+            midi.addEvent(juce::MidiMessage::noteOn(1, nota, 0.8f), 0);
+            pedida.processBlock(buffer, midi);
+            midi.clear();
+            pedida.processBlock(buffer, midi);
+            expectEquals((int) pedida.getNumCuerda().size(), 1);
+            const int porDefecto = pedida.getNumCuerda().empty() ? -1 : pedida.getNumCuerda()[0];
+            const int otra = porDefecto == 5 ? 4 : 5;
+
+            midi.addEvent(juce::MidiMessage::noteOff(1, nota), 0);
+            pedida.processBlock(buffer, midi);
+            midi.clear();
+            soltarTodo();
+
+            // Note on y note off del editor en el mismo bloque
+            pedida.postNoteOn(nota, 0.8f, otra);
+            pedida.postNoteOff(nota);
+            pedida.processBlock(buffer, midi);
+            pedida.processBlock(buffer, midi);
+            expectEquals(cuenta(otra), 1, "note on y note off en el mismo bloque");
+            soltarTodo();
+
+            // La nota del editor sigue pulsada cuando llega la misma nota del host
+            pedida.postNoteOn(nota, 0.8f, otra);
+            pedida.processBlock(buffer, midi);
+            midi.addEvent(juce::MidiMessage::noteOn(1, nota, 0.8f), 0);
+            pedida.processBlock(buffer, midi);
+            midi.clear();
+            pedida.processBlock(buffer, midi);
+            expectEquals(cuenta(otra), 1, "nota del editor");
+            expectEquals(cuenta(porDefecto), 1, "nota del host");
+
+            pedida.postNoteOff(nota);
+            soltarTodo();
+        }
+
+        beginTest("Instancias que se preparan a la vez");
+        {
+            // La tabla de calibración de una frecuencia se construye una vez y la comparten las
+            // instancias: dos que la piden a la vez no se bloquean ni tocan las voces de la otra
+            const double otraFrecuencia = 44100.0;
+            SynthAudioProcessor a, b;
+
+            std::thread hiloA([&] { a.setRateAndBufferSizeDetails(otraFrecuencia, blockSize); a.prepareToPlay(otraFrecuencia, blockSize); });
+            std::thread hiloB([&] { b.setRateAndBufferSizeDetails(otraFrecuencia, blockSize); b.prepareToPlay(otraFrecuencia, blockSize); });
+            hiloA.join();
+            hiloB.join();
+
+            for (auto* p : { &a, &b }) {
+                juce::AudioBuffer<float> audio(1, (int) otraFrecuencia / 2);
+                juce::AudioBuffer<float> bloque(p->getTotalNumOutputChannels(), blockSize);
+                audio.clear();
+                midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
+
+                for (int s = 0; s + blockSize <= audio.getNumSamples(); s += blockSize) {
+                    bloque.clear();
+                    p->processBlock(bloque, midi);
+                    midi.clear();
+                    audio.copyFrom(0, s, bloque, 0, 0, blockSize);
+                }
+
+                const double f = juce::MidiMessage::getMidiNoteInHertz(60);
+                const double medida = test::estimatePitch(audio, otraFrecuencia, 0.97 * f, 1.03 * f);
+                expectLessThan(std::abs(test::cents(medida, f)), 2.0, "instancia desafinada");
+            }
+        }
+    }
+};
+
+static ProcessorTests processorTests;
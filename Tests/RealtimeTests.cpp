@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    RealtimeTests.cpp
+    Created: 19 Oct 2026
+
+    processBlock no debe reservar memoria, esperar en un lock ni hacer llamadas
+    al sistema bloqueantes. Los interceptores de Tools/RtCheck están enlazados
+    en harpejji_tests y cuentan cada infracción hecha dentro del bloque.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "RealtimeCheck.h"
+
+class RealtimeTests : public juce::UnitTest
+{
+public:
+    RealtimeTests() : juce::UnitTest("Tiempo real", "Harpejji") {}
+
+    void runTest() override
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 256;
+
+        SynthAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        juce::Random rnd(1);
+
+        // El primer bloque puede inicializar estado perezoso de JUCE; no cuenta
+        processor.processBlock(buffer, midi);
+
+        beginTest("Notas, pitch bend, deslizamiento y automatización sin infracciones");
+        {
+            const auto antes = rtcheck::getNumViolations();
+
+            for (int b = 0; b < 400; b++) {
+                midi.clear();
+
+                // Tormenta MIDI cada 50 bloques, y alguna nota suelta el resto del tiempo
+                const int numEventos = b % 50 == 0 ? 48 : rnd.nextInt(3);
+                for (int i = 0; i < numEventos; i++) {
+                    const int nota = 36 + rnd.nextInt(49);
+                    midi.addEvent(rnd.nextBool() ? juce::MidiMessage::noteOn(1, nota, (juce::uint8) (1 + rnd.nextInt(127)))
+                                                 : juce::MidiMessage::noteOff(1, nota), rnd.nextInt(blockSize));
+                }
+                midi.addEvent(juce::MidiMessage::pitchWheel(1, rnd.nextInt(16384)), rnd.nextInt(blockSize));
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, SynthVoice::ccDeslizamiento, rnd.nextInt(128)), rnd.nextInt(blockSize));
+
+                for (auto* p : processor.getParameters())
+                    p->setValueNotifyingHost(rnd.nextFloat());
+
+                processor.processBlock(buffer, midi);
+            }
+
+            expectEquals((int) (rtcheck::getNumViolations() - antes), 0);
+        }
+
+        beginTest("El editor leyendo el estado de las cuerdas no bloquea el audio");
+        {
+            // Hace lo mismo que el timer del editor, sin pausa, para forzar la contención
+            struct Lector : juce::Thread
+            {
+                explicit Lector(SynthAudioProcessor& p) : juce::Thread("Lector"), processor(p) {}
+
+                void run() override
+                {
+                    while (!threadShouldExit())
+                        juce::ignoreUnused(processor.getNumCuerda(), processor.getNumTraste(), processor.getVisual());
+                }
+
+                SynthAudioProcessor& processor;
+            };
+
+            Lector lector(processor);
+            lector.startThread();
+
+            const auto antes = rtcheck::getNumViolations();
+
+            for (int b = 0; b < 400; b++) {
+                midi.clear();
+                if (b % 8 == 0)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, 36 + rnd.nextInt(49), (juce::uint8) 100), 0);
+
+                processor.processBlock(buffer, midi);
+            }
+
+            expectEquals((int) (rtcheck::getNumViolations() - antes), 0);
+
+            lector.stopThread(1000);
+        }
+    }
+};
+
+static RealtimeTests realtimeTests;
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    SharedMetricsTests.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "SharedMetrics.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/wait.h>
+ #include <unistd.h>
+#endif
+
+class SharedMetricsTests : public juce::UnitTest
+{
+public:
+    SharedMetricsTests() : juce::UnitTest("Memoria compartida", "Harpejji") {}
+
+    void runTest() override
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        const auto nombre = "/harpejji-test-" + juce::String((int) getpid());
+
+        beginTest("El procesador publica sus métricas");
+        {
+            setenv("HARPEJJI_SHM", nombre.toRawUTF8(), 1);
+            SynthAudioProcessor processor;
+            unsetenv("HARPEJJI_SHM");
+
+            processor.setMaskingCulling(0.5f);
+            processor.setRateAndBufferSizeDetails(48000.0, 256);
+            processor.prepareToPlay(48000.0, 256);
+
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), 256);
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(1, 48, 0.8f), 0);
+            midi.addEvent(juce::MidiMessage::noteOn(1, 55, 0.8f), 0);
+
+            for (int b = 0; b < 10; b++) {
+                processor.processBlock(buffer, midi);
+                midi.clear();
+            }
+
+            const auto* layout = abrir(nombre);
+            expect(layout != nullptr);
+
+            if (layout != nullptr) {
+                SharedMetrics::Payload m;
+                expect(SharedMetrics::read(*layout, m));
+                expectEquals(layout->pid, (juce::int32) getpid());
+                expectEquals((int) m.numBlocks, 10);
+                expectEquals(m.activeVoices, 2);
+                expectEquals(m.blockSize, 256);
+                expectEquals(m.sampleRate, 48000.0);
+                expect(m.load > 0.0f && m.maxLoad >= m.load);
+                expectEquals(m.maskingAggressiveness, 0.5f);
+                expectEquals((int) m.voicesMasked, 0);      // Las notas tienen menos de MaskingCulling::edadMinima
+                expectEquals(m.qualityTier, 0);
+                munmap((void*) layout, sizeof(SharedMetrics::Layout));
+            }
+        }
+
+        expect(abrir(nombre) == nullptr, "El segmento se borra al destruir el procesador");
+
+        beginTest("Una segunda instancia no pisa el segmento de la primera");
+        {
+            auto primera = SharedMetrics::create(nombre);
+            auto segunda = SharedMetrics::create(nombre);
+            expect(primera != nullptr && segunda != nullptr);
+
+            if (primera != nullptr && segunda != nullptr) {
+                expectEquals(primera->getName(), nombre);
+                expectEquals(segunda->getName(), nombre + "-2");
+
+                SharedMetrics::Payload p;
+                p.numBlocks = 7;
+                primera->publish(p);
+                segunda.reset();
+
+                const auto* layout = abrir(nombre);
+                expect(layout != nullptr, "La segunda instancia borra el segmento de la primera");
+
+                if (layout != nullptr) {
+                    SharedMetrics::Payload m;
+                    expect(SharedMetrics::read(*layout, m));
+                    expectEquals((int) m.numBlocks, 7);
+                    munmap((void*) layout, sizeof(SharedMetrics::Layout));
+                }
+            }
+        }
+
+        beginTest("Se reutiliza el segmento de un proceso que ya no existe");
+        {
+            const pid_t hijo = fork();
+            if (hijo == 0) {
+                SharedMetrics::create(nombre).release();      // Sale sin destruirlo, como tras un cierre inesperado
+                _exit(0);
+            }
+
+            waitpid(hijo, nullptr, 0);
+
+            auto shm = SharedMetrics::create(nombre);
+            expect(shm != nullptr);
+            if (shm != nullptr)
+                expectEquals(shm->getName(), nombre);
+        }
+
+        beginTest("El lector nunca ve una escritura a medias");
+        {
+            auto shm = SharedMetrics::create(nombre);
+            expect(shm != nullptr);
+
+            if (shm != nullptr) {
+                const auto* layout = abrir(nombre);
+                std::atomic<bool> salir { false };
+                int incoherentes = 0, lecturas = 0;
+
+                // Escritor: todos los campos enteros con el mismo valor en cada publicación
+                std::thread escritor([&] {
+                    SharedMetrics::Payload p;
+                    for (juce::uint64 n = 1; !salir.load(); n++) {
+                        p.numBlocks = p.xruns = p.voicesSilenced = p.droppedNotes = p.voicesQuarantined = p.voicesMasked = n;
+                        p.maskingAggressiveness = (float) n;
+                        p.blockSize = p.activeVoices = p.qualityTier = (juce::int32) n;
+                        shm->publish(p);
+                    }
+                });
+
+                const auto fin = juce::Time::getMillisecondCounter() + 300;
+                SharedMetrics::Payload m;
+
+                while (juce::Time::getMillisecondCounter() < fin) {
+                    if (!SharedMetrics::read(*layout, m))
+                        continue;
+
+                    lecturas++;
+                    if (m.xruns != m.numBlocks || m.voicesSilenced != m.numBlocks || m.droppedNotes != m.numBlocks || m.voicesQuarantined != m.numBlocks
+                        || m.voicesMasked != m.numBlocks || m.maskingAggressiveness != (float) m.numBlocks
+                        || m.blockSize != (juce::int32) m.numBlocks || m.qualityTier != (juce::int32) m.numBlocks)
+                        incoherentes++;
+                }
+
+                salir = true;
+                escritor.join();
+
+                expect(lecturas > 0);
+                expectEquals(incoherentes, 0);
+                munmap((void*) layout, sizeof(SharedMetrics::Layout));
+            }
+        }
+       #endif
+    }
+
+private:
+   #if JUCE_LINUX || JUCE_MAC
+    static const SharedMetrics::Layout* abrir(const juce::String& nombre)
+    {
+        const int fd = shm_open(nombre.toRawUTF8(), O_RDONLY, 0);
+        if (fd < 0)
+            return nullptr;
+
+        void* p = mmap(nullptr, sizeof(SharedMetrics::Layout), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        return p != MAP_FAILED ? static_cast<const SharedMetrics::Layout*>(p) : nullptr;
+    }
+   #endif
+};
+
+static SharedMetricsTests sharedMetricsTests;
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    StabilityTests.cpp
+    Created: 19 Oct 2026
+
+    Barrido de todas las notas x tensión x sustain x frecuencia de muestreo:
+    la salida tiene que ser finita y, como el modelo solo tiene pérdidas, la
+    energía no puede crecer después del ataque.
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+
+class StabilityTests : public juce::UnitTest
+{
+public:
+    StabilityTests() : juce::UnitTest("Stability sweep", "Harpejji") {}
+
+    void runTest() override
+    {
+        const bool rapido = test::getConfig().quick;
+
+        const std::vector<double> sampleRates = rapido ? std::vector<double> { 48000.0 }
+                                                       : std::vector<double> { 44100.0, 48000.0, 96000.0, 192000.0 };
+        const std::vector<float> tensiones = rapido ? std::vector<float> { 0.1f, 1.0f, 1.4f }
+                                                    : std::vector<float> { 0.1f, 0.4f, 0.7f, 1.0f, 1.4f };
+        const std::vector<float> sustains = rapido ? std::vector<float> { 1.0f }
+                                                   : std::vector<float> { 0.1f, 0.5f, 1.0f };
+
+        for (double sr : sampleRates) {
+            beginTest("sr " + juce::String((int) sr));
+
+            for (float tension : tensiones)
+                for (float sustain : sustains)
+                    for (int nota = 36; nota <= 84; nota++)
+                        checkCase(nota, tension, sustain, sr);
+        }
+    }
+
+private:
+    void checkCase(int nota, float tension, float sustain, double sr)
+    {
+        test::Render r;
+        r.sampleRate = sr;
+        r.blockSize = 256;
+        r.segundos = 0.5;
+        r.parametros = { { "TENSION", tension }, { "SUSTAIN", sustain } };
+
+        const auto audio = test::render({ { 0.0, 0.5, nota, 0.8f } }, r);
+        const auto caso = "nota " + juce::String(nota) + " tension " + juce::String(tension, 1)
+                        + " sustain " + juce::String(sustain, 1) + " sr " + juce::String((int) sr);
+
+        if (!test::allFinite(audio)) {
+            expect(false, "salida no finita: " + caso);
+            return;
+        }
+
+        // Ventanas de 10 ms: tras los primeros 100 ms (ataque y llegada de la
+        // onda a la pastilla) ninguna ventana puede superar el doble del máximo inicial
+        const auto energia = test::windowEnergy(audio, (int) (0.01 * sr));
+        const size_t ataque = juce::jmin<size_t>(10, energia.size());
+
+        const double maxAtaque = energia.empty() ? 0.0 : *std::max_element(energia.begin(), energia.begin() + (long) ataque);
+        const double maxDespues = ataque < energia.size() ? *std::max_element(energia.begin() + (long) ataque, energia.end()) : 0.0;
+
+        expect(maxDespues <= 2.0 * maxAtaque + 1.0e-12, "la energía crece: " + caso);
+    }
+};
+
+static StabilityTests stabilityTests;
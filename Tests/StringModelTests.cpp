@@ -0,0 +1,666 @@
+/*
+  ==============================================================================
+
+    StringModelTests.cpp
+    Created: 19 Oct 2026
+
+    Propiedades físicas del modelo de cuerda, medidas sobre una SynthVoice
+    aislada (sin el filtro ni la ganancia del procesador): inarmonicidad de
+    la cuerda rígida, coste (puntos de malla) de cada nota y pérdidas
+    implícitas con mallas más gruesas, y precisión frente a coste de los
+    operadores espaciales de segundo y cuarto orden, afinación de todas las
+    notas con la calibración, tablas de calibración precalculadas, y pitch
+    bend y deslizamiento con el extremo móvil.
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+#include "SynthVoice.h"
+#include "SynthSound.h"
+
+// Amigo de SynthVoice: saca la nota que suena de los límites de sus parámetros
+struct SynthVoiceTestAccess
+{
+    // Multiplica s1 sin cambiar la malla, que sigue siendo la estable para el s1 de la cuerda. Con un
+    // factor grande el esquema explícito deja de ser estable y el implícito no (la malla no se
+    // ajusta a las pérdidas, como haría calcularDxMin)
+    static void scaleLosses(SynthVoice& voice, float factor)
+    {
+        voice.s1 *= factor;
+        voice.calcularCoeficientes();
+    }
+
+    // Como setGridScale pero sin el límite de 1: con más de 1 la malla es más fina que la estable
+    static void setGridScale(SynthVoice& voice, float newLambda)
+    {
+        voice.lambda = juce::jmax(0.1f, newLambda);
+    }
+};
+
+namespace
+{
+    struct Voz
+    {
+        juce::Synthesiser synth;
+        SynthVoice* voice = nullptr;
+
+        Voz(double sampleRate, float tension, float theta = 0.0f, float gridScale = 1.0f, int spatialOrder = 2)
+        {
+            // Synthesiser de una sola voz para que la voz quede activa (isVoiceActive)
+            voice = new SynthVoice();
+            synth.addVoice(voice);
+            synth.addSound(new SynthSound());
+            synth.setCurrentPlaybackSampleRate(sampleRate);
+            voice->prepareToPlay(sampleRate, 512, 1);
+            voice->updateParams(tension, 1.0f);
+            voice->setLossTheta(theta);
+            voice->setGridScale(gridScale);
+            voice->setSpatialOrder(spatialOrder);
+        }
+
+        juce::AudioBuffer<float> render(int nota, int numSamples, int deslizamiento = 0)
+        {
+            synth.noteOn(1, nota, 0.8f);
+            if (deslizamiento > 0)
+                synth.handleController(1, SynthVoice::ccDeslizamiento, deslizamiento);
+
+            juce::AudioBuffer<float> audio(1, numSamples);
+            audio.clear();
+            voice->renderNextBlock(audio, 0, numSamples);
+            return audio;
+        }
+    };
+
+    // Error máximo (cents) de los primeros parciales respecto a la cuerda rígida continua,
+    // f_p = p f sqrt((1 + B p^2) / (1 + B)). El 5 se salta: la pastilla (0.8) está en su nodo.
+    double errorParciales(const juce::AudioBuffer<float>& audio, double sampleRate, int nota, double B)
+    {
+        const double f = juce::MidiMessage::getMidiNoteInHertz(nota);
+        double error = 0.0;
+
+        for (int p : { 1, 2, 3, 4, 6, 7, 8 }) {
+            const double esperado = p * f * std::sqrt((1.0 + B * p * p) / (1.0 + B));
+            const double medido = test::estimatePitch(audio, sampleRate, 0.97 * esperado, 1.03 * esperado);
+            error = juce::jmax(error, std::abs(test::cents(medido, esperado)));
+        }
+
+        return error;
+    }
+}
+
+class StringModelTests : public juce::UnitTest
+{
+public:
+    StringModelTests() : juce::UnitTest("String model", "Harpejji") {}
+
+    void runTest() override
+    {
+        const double sr = 48000.0;
+
+        beginTest("Inarmonicidad de la cuerda rígida");
+        {
+            // Del parcial p y la fundamental: (f_p / (p f_1))^2 = (1 + B p^2) / (1 + B)
+            for (int nota : { 36, 40, 45 }) {
+                Voz v(sr, 1.0f);
+                const auto audio = v.render(nota, (int) sr);
+                const double B = v.voice->getInharmonicity();
+                const double f = juce::MidiMessage::getMidiNoteInHertz(nota);
+
+                expectGreaterThan(B, 1.0e-4, "nota " + juce::String(nota) + " sin rigidez");
+
+                const double f1 = test::estimatePitch(audio, sr, 0.97 * f, 1.03 * f);
+
+                for (int p : { 4, 8 }) {
+                    const double esperado = p * f * std::sqrt((1.0 + B * p * p) / (1.0 + B));
+                    const double fp = test::estimatePitch(audio, sr, 0.97 * esperado, 1.03 * esperado);
+                    const double r = fp / (p * f1);
+                    const double medido = (r * r - 1.0) / (p * p - r * r);
+
+                    logMessage("nota " + juce::String(nota) + " parcial " + juce::String(p) + ": B " + juce::String(B, 6)
+                               + " medido " + juce::String(medido, 6));
+                    expectWithinAbsoluteError(medido, B, 0.1 * B);
+                }
+            }
+        }
+
+        beginTest("La rigidez no aumenta los puntos de malla");
+        {
+            // Sin rigidez la malla más fina estable tiene X = fs / (2 f) puntos (Courant = 1),
+            // con cualquier tensión
+            for (float tension : { 0.1f, 0.7f, 1.0f, 1.4f }) {
+                Voz v(sr, tension);
+
+                for (int nota = 36; nota <= 84; nota++) {
+                    v.render(nota, 16);
+                    const double sinRigidez = sr / (2.0 * juce::MidiMessage::getMidiNoteInHertz(nota));
+
+                    expectLessOrEqual((double) v.voice->getNumPuntos(), 1.01 * sinRigidez + 1.0,
+                                      "nota " + juce::String(nota) + " tension " + juce::String(tension, 1));
+                }
+            }
+        }
+
+        beginTest("Pérdidas implícitas");
+        {
+            // Con las pérdidas de la cuerda, el esquema implícito (theta = 1) suena casi igual que el explícito
+            for (int nota : { 36, 60, 84 }) {
+                Voz explicito(sr, 1.0f, 0.0f), implicito(sr, 1.0f, 1.0f);
+                const auto a = explicito.render(nota, (int) sr);
+                const auto b = implicito.render(nota, (int) sr);
+
+                expectEquals(implicito.voice->getNumPuntos(), explicito.voice->getNumPuntos());
+
+                float error = 0.0f;
+                for (int s = 0; s < a.getNumSamples(); s++)
+                    error = juce::jmax(error, std::abs(a.getSample(0, s) - b.getSample(0, s)));
+
+                expectLessThan(error / a.getMagnitude(0, 0, a.getNumSamples()), 0.05f, "nota " + juce::String(nota));
+            }
+        }
+
+        beginTest("Pérdidas fuertes: implícitas estables, explícitas no");
+        {
+            // Con s1 x3000 sobre la malla de la cuerda nominal, el término explícito de las pérdidas
+            // saca al esquema del límite de estabilidad; el implícito no tiene límite por s1
+            for (int nota : { 36, 60, 84 })
+                for (float theta : { 0.0f, 1.0f }) {
+                    Voz v(sr, 1.0f, theta);
+                    v.synth.noteOn(1, nota, 0.8f);
+                    SynthVoiceTestAccess::scaleLosses(*v.voice, 3000.0f);
+
+                    const auto caso = "nota " + juce::String(nota) + " theta " + juce::String(theta, 1);
+                    juce::AudioBuffer<float> audio(1, (int) (0.5 * sr));
+                    audio.clear();
+                    int inestables = 0;
+
+                    for (int s = 0; s + 256 <= audio.getNumSamples(); s += 256) {
+                        v.voice->renderNextBlock(audio, s, 256);
+                        inestables += v.voice->takeBlockStats().notasInestables;
+                    }
+
+                    expect(test::allFinite(audio), "salida no finita: " + caso);
+
+                    if (theta > 0.0f) {
+                        expectEquals(inestables, 0, caso);
+
+                        const auto energia = test::windowEnergy(audio, (int) (0.01 * sr));
+                        const double maxAtaque = *std::max_element(energia.begin(), energia.begin() + 10);
+                        expectGreaterThan(maxAtaque, 0.0, caso);
+                        expect(energia.back() < 0.5 * maxAtaque, "no decae: " + caso);
+                        expect(*std::max_element(energia.begin() + 10, energia.end()) <= maxAtaque, "la energía crece: " + caso);
+                    }
+                    else {
+                        // El monitor de energía la retira en el primer bloque, antes de sumarlo a la salida
+                        expectEquals(inestables, 1, caso);
+                        expect(!v.voice->isVoiceActive(), "la voz sigue activa: " + caso);
+                        expectEquals(audio.getMagnitude(0, 0, audio.getNumSamples()), 0.0f, caso);
+                    }
+                }
+        }
+
+        beginTest("Mallas más gruesas");
+        {
+            // setGridScale reduce los puntos en proporción y sigue siendo estable
+            for (float theta : { 0.0f, 1.0f })
+                for (float escala : { 0.5f, 0.25f }) {
+                    Voz fina(sr, 1.0f, theta), gruesa(sr, 1.0f, theta, escala);
+
+                    for (int nota = 36; nota <= 84; nota += 4) {
+                        fina.render(nota, 16);
+                        const auto audio = gruesa.render(nota, (int) (0.5 * sr));
+                        const auto caso = "nota " + juce::String(nota) + " theta " + juce::String(theta, 1) + " escala " + juce::String(escala, 2);
+
+                        expect(test::allFinite(audio), "salida no finita: " + caso);
+                        expectLessOrEqual(gruesa.voice->getNumPuntos(), juce::jmax(4, (int) std::ceil(escala * fina.voice->getNumPuntos())), caso);
+
+                        const auto energia = test::windowEnergy(audio, (int) (0.01 * sr));
+                        const double maxAtaque = *std::max_element(energia.begin(), energia.begin() + 10);
+                        const double maxDespues = *std::max_element(energia.begin() + 10, energia.end());
+                        expect(maxDespues <= 2.0 * maxAtaque + 1.0e-12, "la energía crece: " + caso);
+                    }
+                }
+        }
+
+        beginTest("Cuarto orden: precisión frente a puntos de malla");
+        {
+            // Las cuerdas graves son las que más puntos tienen. Con cuarto orden la misma precisión
+            // en los primeros parciales necesita una malla más gruesa (y el coste por punto es el mismo)
+            juce::int64 puntosSegundo = 0, puntosCuarto = 0;
+
+            for (int nota : { 36, 40, 45, 52, 60 }) {
+                Voz referencia(sr, 1.0f, 0.0f, 1.0f, 2);
+                const double errorReferencia = errorParciales(referencia.render(nota, (int) sr), sr, nota,
+                                                              referencia.voice->getInharmonicity());
+                const int puntosReferencia = referencia.voice->getNumPuntos();
+
+                for (float escala : { 1.0f, 0.75f, 0.5f }) {
+                    Voz segundo(sr, 1.0f, 0.0f, escala, 2), cuarto(sr, 1.0f, 0.0f, escala, 4);
+                    const double error2 = errorParciales(segundo.render(nota, (int) sr), sr, nota, segundo.voice->getInharmonicity());
+                    const double error4 = errorParciales(cuarto.render(nota, (int) sr), sr, nota, cuarto.voice->getInharmonicity());
+
+                    logMessage("nota " + juce::String(nota) + " escala " + juce::String(escala, 2)
+                               + ": orden 2 " + juce::String(segundo.voice->getNumPuntos()) + " puntos " + juce::String(error2, 2) + " cents"
+                               + ", orden 4 " + juce::String(cuarto.voice->getNumPuntos()) + " puntos " + juce::String(error4, 2) + " cents");
+
+                    expectLessOrEqual(error4, error2 + 0.5, "nota " + juce::String(nota) + " escala " + juce::String(escala, 2));
+
+                    if (escala == 0.75f) {
+                        // Cuarto orden con el 75 % de la malla, tan preciso como segundo orden con toda
+                        expectLessOrEqual(error4, 1.15 * errorReferencia + 0.5, "nota " + juce::String(nota));
+                        expectLessOrEqual((double) cuarto.voice->getNumPuntos(), 0.8 * puntosReferencia, "nota " + juce::String(nota));
+
+                        puntosSegundo += puntosReferencia;
+                        puntosCuarto += cuarto.voice->getNumPuntos();
+                    }
+                }
+            }
+
+            logMessage("puntos a igual precisión: orden 2 " + juce::String(puntosSegundo) + ", orden 4 " + juce::String(puntosCuarto));
+        }
+
+        beginTest("Afinación de todas las notas con la calibración");
+        {
+            // 0.55 cae entre dos tensiones de la tabla (se interpola)
+            for (float escala : { 1.0f, 0.5f })
+                for (float tension : { 1.0f, 0.55f }) {
+                    Voz sinCalibrar(sr, tension, 0.0f, escala), calibrada(sr, tension, 0.0f, escala);
+
+                    PitchCalibration tabla;
+                    calibrada.voice->calibratePitch(tabla);
+                    calibrada.voice->setPitchCalibration(&tabla);
+
+                    double errorMax = 0.0, errorMaxSinCalibrar = 0.0;
+
+                    for (int nota = 36; nota <= 84; nota++) {
+                        const double f = juce::MidiMessage::getMidiNoteInHertz(nota);
+                        const double error = test::cents(test::estimatePitch(calibrada.render(nota, 2 * (int) sr), sr, 0.97 * f, 1.03 * f), f);
+                        const double errorSinCalibrar = test::cents(test::estimatePitch(sinCalibrar.render(nota, 2 * (int) sr), sr, 0.97 * f, 1.03 * f), f);
+
+                        logMessage("escala " + juce::String(escala, 2) + " tension " + juce::String(tension, 2) + " nota " + juce::String(nota)
+                                   + ": " + juce::String(error, 2) + " cents (sin calibrar " + juce::String(errorSinCalibrar, 2) + ")");
+
+                        expectLessOrEqual(std::abs(error), 1.0, "nota " + juce::String(nota) + " escala " + juce::String(escala, 2)
+                                                                + " tension " + juce::String(tension, 2));
+
+                        errorMax = juce::jmax(errorMax, std::abs(error));
+                        errorMaxSinCalibrar = juce::jmax(errorMaxSinCalibrar, std::abs(errorSinCalibrar));
+                    }
+
+                    logMessage("escala " + juce::String(escala, 2) + " tension " + juce::String(tension, 2) + ": error máximo "
+                               + juce::String(errorMax, 2) + " cents (sin calibrar " + juce::String(errorMaxSinCalibrar, 2) + ")");
+                }
+        }
+
+        beginTest("Tablas de calibración precalculadas");
+        {
+            // El procesador no mide la calibración: interpola PitchCalibrationTables.h, que tiene que
+            // coincidir con lo que mide calibratePitch (si cambia el modelo, --update-calibration)
+            using namespace pitchCalibrationTables;
+            const auto& config = test::getConfig();
+            std::vector<PitchCalibration> medidas((size_t) numSampleRates);
+
+            for (int i = 0; i < numSampleRates; i++) {
+                Voz v(sampleRates[i], 1.0f);
+                v.voice->calibratePitch(medidas[(size_t) i]);
+
+                PitchCalibration precalculada;
+                precalculada.setPrecomputed(sampleRates[i]);
+
+                float diferencia = 0.0f;
+                for (int nota = PitchCalibration::firstNote; nota < PitchCalibration::firstNote + numNotes; nota++)
+                    for (int t = 0; t < numTensions; t++)
+                        diferencia = juce::jmax(diferencia, std::abs(medidas[(size_t) i].getCents(nota, t) - precalculada.getCents(nota, t)));
+
+                logMessage(juce::String(sampleRates[i], 0) + " Hz: diferencia máxima " + juce::String(diferencia, 3) + " cents");
+                if (!config.updateCalibration)
+                    expectLessOrEqual(diferencia, 0.02f, juce::String(sampleRates[i], 0) + " Hz: regenerar con --update-calibration");
+            }
+
+            // Entre dos frecuencias de la tabla
+            {
+                const double frecuencia = 64000.0;
+                Voz v(frecuencia, 1.0f);
+                PitchCalibration medida, interpolada;
+                v.voice->calibratePitch(medida);
+                interpolada.setPrecomputed(frecuencia);
+
+                float diferencia = 0.0f;
+                for (int nota = PitchCalibration::firstNote; nota < PitchCalibration::firstNote + numNotes; nota++)
+                    for (int t = 0; t < numTensions; t++)
+                        diferencia = juce::jmax(diferencia, std::abs(medida.getCents(nota, t) - interpolada.getCents(nota, t)));
+
+                logMessage("64000 Hz interpolada: diferencia máxima " + juce::String(diferencia, 3) + " cents");
+                expectLessOrEqual(diferencia, 0.5f);
+            }
+
+            if (config.updateCalibration) {
+                juce::String texto;
+                texto << "/*\n"
+                         "  ==============================================================================\n\n"
+                         "    PitchCalibrationTables.h\n"
+                         "    Generado por harpejji_tests --update-calibration: no editar a mano.\n\n"
+                         "  ==============================================================================\n"
+                         "*/\n\n"
+                         "#pragma once\n\n"
+                         "// Tablas de PitchCalibration medidas con SynthVoice::calibratePitch (malla por\n"
+                         "// defecto) en las frecuencias de muestreo habituales: cents[frecuencia][nota - 36][tensión]\n"
+                         "namespace pitchCalibrationTables\n"
+                         "{\n"
+                      << "    constexpr int numSampleRates = " << numSampleRates << ";\n"
+                      << "    constexpr int numNotes = " << numNotes << ";\n"
+                      << "    constexpr int numTensions = " << numTensions << ";\n\n"
+                      << "    constexpr double sampleRates[numSampleRates] = { ";
+
+                for (int i = 0; i < numSampleRates; i++)
+                    texto << juce::String(sampleRates[i], 1) << (i < numSampleRates - 1 ? ", " : " };\n\n");
+
+                texto << "    constexpr float cents[numSampleRates][numNotes][numTensions] =\n"
+                         "    {\n";
+
+                for (int i = 0; i < numSampleRates; i++) {
+                    texto << "        {   // " << juce::String(sampleRates[i], 0) << " Hz\n";
+
+                    for (int n = 0; n < numNotes; n++) {
+                        texto << "            { ";
+                        for (int t = 0; t < numTensions; t++)
+                            texto << juce::String(medidas[(size_t) i].getCents(PitchCalibration::firstNote + n, t), 3) << "f"
+                                  << (t < numTensions - 1 ? ", " : " }");
+                        texto << (n < numNotes - 1 ? ",\n" : "\n");
+                    }
+
+                    texto << (i < numSampleRates - 1 ? "        },\n" : "        }\n");
+                }
+
+                texto << "    };\n"
+                         "}\n";
+
+                expect(config.calibrationFile.replaceWithText(texto, false, false, "\n"), "no se puede escribir " + config.calibrationFile.getFullPathName());
+                logMessage("Calibración escrita en " + config.calibrationFile.getFullPathName());
+            }
+        }
+
+        beginTest("Pitch bend y deslizamiento");
+        {
+            // El extremo se mueve dentro de la malla de la nota (X no cambia) y la afinación sigue
+            // al bend; con el deslizamiento al máximo la cuerda sube una octava más
+            Voz v(sr, 1.0f);
+            PitchCalibration tabla;
+            v.voice->calibratePitch(tabla);
+            v.voice->setPitchCalibration(&tabla);
+
+            for (int nota : { 36, 48, 60, 72 }) {
+                v.synth.handlePitchWheel(1, 8192);
+                v.render(nota, 16);
+                const int puntos = v.voice->getNumPuntos();
+
+                for (int rueda : { 0, 4096, 12288, 16383 })
+                    for (int deslizamiento : { 0, 127 }) {
+                        v.synth.handlePitchWheel(1, rueda);
+                        const auto audio = v.render(nota, (int) sr, deslizamiento);
+
+                        const double semitonos = SynthVoice::rangoBend * (rueda - 8192) / (rueda > 8192 ? 8191.0 : 8192.0)
+                                               + SynthVoice::rangoDeslizamiento * deslizamiento / 127.0;
+                        const double f = juce::MidiMessage::getMidiNoteInHertz(nota) * std::pow(2.0, semitonos / 12.0);
+                        const double error = test::cents(test::estimatePitch(audio, sr, 0.97 * f, 1.03 * f), f);
+                        const auto caso = "nota " + juce::String(nota) + " rueda " + juce::String(rueda) + " deslizamiento " + juce::String(deslizamiento);
+
+                        logMessage(caso + ": " + juce::String(v.voice->getFrontera(), 2) + " de " + juce::String(puntos) + " puntos, "
+                                   + juce::String(error, 2) + " cents");
+
+                        expectEquals(v.voice->getNumPuntos(), puntos, caso);
+                        expectLessOrEqual(std::abs(error), 1.0, caso);
+                    }
+            }
+
+            v.synth.handlePitchWheel(1, 8192);
+        }
+
+        beginTest("Extremo justo después de un punto de la malla");
+        {
+            // El último punto actualizado sigue la forma de la cuerda: cerca del extremo apoyado,
+            // u[xFin] ~ alfa / (1 + alfa) u[xFin - 1] con alfa = frontera - xFin. Si quedara a
+            // menos de medio paso del extremo estaría casi desacoplado y vibraría por su cuenta
+            for (int nota : { 36, 48, 60, 72, 84 }) {
+                Voz v(sr, 1.0f);
+                float frontera = 0.0f;
+
+                // Bend con el extremo a menos de 0.02 pasos por encima de un punto
+                for (int rueda = 8193; rueda < 16383; rueda++) {
+                    v.synth.handlePitchWheel(1, rueda);
+                    v.render(nota, 16);
+                    frontera = v.voice->getFrontera();
+
+                    if (frontera > std::floor(frontera) && frontera - std::floor(frontera) < 0.02f)
+                        break;
+                }
+
+                juce::AudioBuffer<float> audio(1, 200);
+                double ultimo = 0.0, anterior = 0.0;
+                int xFin = 0;
+
+                for (int b = 0; b < 120; b++) {
+                    audio.clear();
+                    v.voice->renderNextBlock(audio, 0, audio.getNumSamples());
+
+                    const auto cuerda = v.voice->getVisual();       // Puntos 0 a xFin + 1 al principio del bloque
+                    if (b < 10 || cuerda.size() < 4)
+                        continue;
+
+                    xFin = (int) cuerda.size() - 2;
+                    ultimo += juce::square((double) cuerda[(size_t) xFin]);
+                    anterior += juce::square((double) cuerda[(size_t) xFin - 1]);
+                }
+
+                const auto caso = "nota " + juce::String(nota) + " frontera " + juce::String(frontera, 3);
+                expectGreaterThan(anterior, 0.0, caso);
+
+                const double alfa = frontera - xFin;
+                const double relacion = std::sqrt(ultimo / anterior) / (alfa / (1.0 + alfa));
+
+                logMessage(caso + ": xFin " + juce::String(xFin) + ", último punto " + juce::String(relacion, 2) + " veces la forma de la cuerda");
+                expectLessOrEqual(relacion, 1.25, caso);
+            }
+        }
+
+        beginTest("Vibrato estable");
+        {
+            // El extremo cambia de celda cada pocos bloques: la cuerda no se reinicia ni gana energía
+            for (float theta : { 0.0f, 1.0f })
+                for (int orden : { 2, 4 }) {
+                    Voz v(sr, 1.0f, theta, 1.0f, orden);
+
+                    for (int nota : { 36, 52, 67, 84 }) {
+                        v.render(nota, 16);
+
+                        juce::AudioBuffer<float> audio(1, (int) sr);
+                        audio.clear();
+
+                        for (int s = 0; s < audio.getNumSamples(); s += 64) {
+                            const double t = s / sr;
+                            v.voice->pitchWheelMoved(8192 + juce::roundToInt(8191.0 * std::sin(juce::MathConstants<double>::twoPi * 6.0 * t)));
+                            v.voice->controllerMoved(SynthVoice::ccDeslizamiento, juce::roundToInt(63.5 - 63.5 * std::cos(juce::MathConstants<double>::twoPi * 1.3 * t)));
+                            v.voice->renderNextBlock(audio, s, juce::jmin(64, audio.getNumSamples() - s));
+                        }
+
+                        const auto caso = "nota " + juce::String(nota) + " theta " + juce::String(theta, 1) + " orden " + juce::String(orden);
+                        expect(test::allFinite(audio), "salida no finita: " + caso);
+
+                        const auto energia = test::windowEnergy(audio, (int) (0.01 * sr));
+                        const double maxAtaque = *std::max_element(energia.begin(), energia.begin() + 10);
+                        const double maxDespues = *std::max_element(energia.begin() + 10, energia.end());
+                        expect(maxDespues <= 2.0 * maxAtaque + 1.0e-12, "la energía crece: " + caso);
+
+                        // Y el monitor de energía no la confunde con una cuerda inestable
+                        expect(v.voice->isVoiceActive(), "voz apagada: " + caso);
+                        expectEquals(v.voice->takeBlockStats().notasInestables, 0, caso);
+                    }
+
+                    v.voice->pitchWheelMoved(8192);
+                }
+        }
+
+        beginTest("Monitor de energía");
+        {
+            // Un estado no finito se detecta en el primer bloque: la voz se libera sin escribir nada
+            Voz v(sr, 1.0f);
+            v.synth.noteOn(1, 60, std::numeric_limits<float>::infinity());
+
+            juce::AudioBuffer<float> audio(1, 256);
+            audio.clear();
+            v.voice->renderNextBlock(audio, 0, audio.getNumSamples());
+
+            expect(test::allFinite(audio), "salida no finita");
+            expectEquals(audio.getMagnitude(0, 0, audio.getNumSamples()), 0.0f);
+            expect(!v.voice->isVoiceActive(), "la voz sigue activa");
+            expectEquals(v.voice->takeBlockStats().notasInestables, 1);
+
+            // La voz vuelve a servir para la nota siguiente
+            const auto siguiente = v.render(60, 4096);
+            expect(test::allFinite(siguiente) && siguiente.getMagnitude(0, 0, siguiente.getNumSamples()) > 0.0f, "la voz no se recupera");
+            expectEquals(v.voice->takeBlockStats().notasInestables, 0);
+        }
+
+        beginTest("Monitor de energía: esquema inestable con estado finito");
+        {
+            // Devuelve el pico de la salida y los samples hasta que el monitor retira la voz
+            auto tocarHastaRetirar = [&] (Voz& v, int nota, int bloque, float escalaPerdidas = 1.0f) {
+                v.synth.noteOn(1, nota, 0.8f);
+                if (escalaPerdidas != 1.0f)
+                    SynthVoiceTestAccess::scaleLosses(*v.voice, escalaPerdidas);
+
+                juce::AudioBuffer<float> audio(1, bloque);
+                float pico = 0.0f;
+                bool finita = true;
+                int samples = 0;
+
+                while (v.voice->isVoiceActive() && samples < (int) sr) {
+                    audio.clear();
+                    v.voice->renderNextBlock(audio, 0, bloque);
+                    finita = finita && test::allFinite(audio);
+                    pico = juce::jmax(pico, audio.getMagnitude(0, 0, bloque));
+                    samples += bloque;
+                }
+
+                expect(finita, "salida no finita: nota " + juce::String(nota));
+                return std::make_pair(pico, samples);
+            };
+
+            // Un punto más de malla que el límite de estabilidad: la cinética se dispara mientras la
+            // total se hace negativa. Con bloques de 32 samples el estado sigue siendo finito al
+            // final del bloque, así que la voz la retira el límite de la cinética, no el de NaN/inf
+            for (int nota : { 36, 48, 60, 72, 84 }) {
+                Voz v(sr, 1.0f);
+                v.render(nota, 16);
+                const int puntos = v.voice->getNumPuntos();
+
+                float escala = 1.0f;
+                while (v.voice->getNumPuntos() == puntos) {
+                    escala += 0.002f;
+                    SynthVoiceTestAccess::setGridScale(*v.voice, escala);
+                    v.render(nota, 1);
+                }
+
+                v.voice->takeBlockStats();
+                const auto r = tocarHastaRetirar(v, nota, 32);
+                const auto caso = "nota " + juce::String(nota) + " con " + juce::String(puntos + 1) + " puntos";
+
+                expectLessOrEqual(r.second, 4 * 32, caso);
+                expectLessThan(r.first, 1.0f, caso);
+                expectEquals(v.voice->takeBlockStats().notasInestables, 1, caso);
+            }
+
+            // Pérdidas negativas: la energía sigue siendo definida positiva y crece despacio, así que
+            // la voz la retira el límite de crecimiento antes de que la salida suba más de un 5 %
+            for (int nota : { 36, 60 })
+                for (float theta : { 0.0f, 1.0f }) {
+                    Voz referencia(sr, 1.0f, theta), v(sr, 1.0f, theta);
+                    const auto picoNormal = referencia.render(nota, (int) sr).getMagnitude(0, 0, (int) sr);
+                    const auto r = tocarHastaRetirar(v, nota, 256, -100.0f);
+                    const auto caso = "nota " + juce::String(nota) + " theta " + juce::String(theta, 1);
+
+                    expectLessThan(r.second, (int) sr, caso);
+                    expectLessOrEqual(r.first, 1.05f * picoNormal, caso);
+                    expectEquals(v.voice->takeBlockStats().notasInestables, 1, caso);
+                }
+        }
+
+        beginTest("Detector de silencio por bloques");
+        {
+            // La voz termina el bloque en el que se apaga: la duración de la nota apenas depende del
+            // tamaño de bloque, y el detector de la cuerda entera evita cortes en los pasos por cero
+            int duracion[2] = {};
+
+            for (int i = 0; i < 2; i++) {
+                const int bloque = i == 0 ? 16 : 512;
+                Voz v(sr, 1.0f);
+                v.render(40, 16);
+                v.voice->stopNote(0.0f, true);
+
+                juce::AudioBuffer<float> audio(1, bloque);
+
+                while (v.voice->isVoiceActive() && duracion[i] < (int) (10.0 * sr)) {
+                    audio.clear();
+                    v.voice->renderNextBlock(audio, 0, bloque);
+                    duracion[i] += bloque;
+                }
+
+                expect(!v.voice->isVoiceActive(), "la voz no se apaga con bloques de " + juce::String(bloque));
+                expectEquals(v.voice->takeBlockStats().notasSilenciadas, 1);
+            }
+
+            logMessage("nota soltada: " + juce::String(duracion[0] / sr, 3) + " s con bloques de 16, "
+                       + juce::String(duracion[1] / sr, 3) + " s con bloques de 512");
+            expectLessOrEqual(std::abs(duracion[1] - duracion[0]), 2 * 512);
+        }
+
+        beginTest("Piso de silencio relativo a la salida");
+        {
+            // Con GAIN bajo, TONE oscuro o un piso más alto la voz se libera antes, cuando su salida
+            // tras la etapa de salida del procesador queda por debajo del piso
+            struct Etapa { float ganancia, corte, pisoDb; };
+
+            auto medir = [this, sr] (int nota, Etapa etapa, double& ultimoDb) {
+                Voz v(sr, 1.0f);
+                v.voice->setOutputStage(etapa.ganancia, etapa.corte, etapa.pisoDb);
+                v.render(nota, 16);
+
+                juce::AudioBuffer<float> audio(1, 256);
+                int duracion = 0;
+
+                while (v.voice->isVoiceActive() && duracion < (int) (60.0 * sr)) {
+                    audio.clear();
+                    v.voice->renderNextBlock(audio, 0, audio.getNumSamples());
+                    duracion += audio.getNumSamples();
+                }
+
+                expect(!v.voice->isVoiceActive(), "la voz no se apaga");
+                ultimoDb = juce::Decibels::gainToDecibels(etapa.ganancia * audio.getRMSLevel(0, 0, audio.getNumSamples()), -200.0f);
+                return duracion / sr;
+            };
+
+            for (int nota : { 40, 60, 80 }) {
+                double ultimoDb = 0.0;
+                const double referencia = medir(nota, { 1.0f, 20000.0f, SynthVoice::pisoSilencioDefecto }, ultimoDb);
+                expectLessOrEqual(ultimoDb, (double) SynthVoice::pisoSilencioDefecto);
+
+                const double gananciaBaja = medir(nota, { 0.001f, 20000.0f, SynthVoice::pisoSilencioDefecto }, ultimoDb);
+                expectLessOrEqual(ultimoDb, (double) SynthVoice::pisoSilencioDefecto);
+
+                const double pisoAlto = medir(nota, { 1.0f, 20000.0f, -60.0f }, ultimoDb);
+                expectLessOrEqual(ultimoDb, -60.0);
+
+                const double oscuro = medir(nota, { 1.0f, 200.0f, SynthVoice::pisoSilencioDefecto }, ultimoDb);
+
+                logMessage("nota " + juce::String(nota) + ": " + juce::String(referencia, 2) + " s, GAIN -60 dB " + juce::String(gananciaBaja, 2)
+                           + " s, piso -60 dBFS " + juce::String(pisoAlto, 2) + " s, TONE 200 Hz " + juce::String(oscuro, 2) + " s");
+
+                expectLessOrEqual(gananciaBaja, 0.5 * referencia);
+                expectLessOrEqual(pisoAlto, 0.75 * referencia);
+                expectLessOrEqual(oscuro, referencia);
+            }
+        }
+    }
+};
+
+static StringModelTests stringModelTests;
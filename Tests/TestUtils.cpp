@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    TestUtils.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "TestUtils.h"
+#include "PluginProcessor.h"
+
+namespace test
+{
+    Config& getConfig()
+    {
+        static Config config;
+        return config;
+    }
+
+    juce::AudioBuffer<float> render(const std::vector<Nota>& notas, const Render& r)
+    {
+        SynthAudioProcessor processor;
+
+        for (const auto& p : r.parametros)
+            if (auto* param = processor.apvts.getParameter(p.first))
+                param->setValueNotifyingHost(param->convertTo0to1(p.second));
+
+        processor.setRateAndBufferSizeDetails(r.sampleRate, r.blockSize);
+        processor.prepareToPlay(r.sampleRate, r.blockSize);
+
+        const int numSamples = (int) (r.segundos * r.sampleRate);
+        juce::AudioBuffer<float> salida(1, numSamples);
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), r.blockSize);
+        juce::MidiBuffer midi;
+
+        for (int pos = 0; pos < numSamples; pos += r.blockSize) {
+            const int n = juce::jmin(r.blockSize, numSamples - pos);
+
+            midi.clear();
+            for (const auto& nota : notas) {
+                const int on = (int) (nota.inicio * r.sampleRate) - pos;
+                const int off = (int) ((nota.inicio + nota.duracion) * r.sampleRate) - pos;
+
+                if (on >= 0 && on < n)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, nota.numero, nota.velocity), on);
+                if (off >= 0 && off < n)
+                    midi.addEvent(juce::MidiMessage::noteOff(1, nota.numero), off);
+            }
+
+            juce::AudioBuffer<float> bloque(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), n);
+            processor.processBlock(bloque, midi);
+            salida.copyFrom(0, pos, bloque, 0, 0, n);
+        }
+
+        return salida;
+    }
+
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(new juce::FileOutputStream(file), sampleRate,
+                                                                            (unsigned int) audio.getNumChannels(), 32, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(new juce::FileInputStream(file), true));
+
+        if (reader == nullptr)
+            return false;
+
+        audio.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+        sampleRate = reader->sampleRate;
+        return reader->read(&audio, 0, (int) reader->lengthInSamples, 0, true, true);
+    }
+
+    bool allFinite(const juce::AudioBuffer<float>& audio)
+    {
+        for (int ch = 0; ch < audio.getNumChannels(); ch++) {
+            const float* x = audio.getReadPointer(ch);
+            for (int s = 0; s < audio.getNumSamples(); s++)
+                if (!std::isfinite(x[s]))
+                    return false;
+        }
+        return true;
+    }
+
+    std::vector<double> windowEnergy(const juce::AudioBuffer<float>& audio, int windowSize)
+    {
+        std::vector<double> energia;
+        const float* x = audio.getReadPointer(0);
+
+        for (int pos = 0; pos + windowSize <= audio.getNumSamples(); pos += windowSize) {
+            double e = 0.0;
+            for (int s = pos; s < pos + windowSize; s++)
+                e += (double) x[s] * x[s];
+            energia.push_back(e);
+        }
+        return energia;
+    }
+
+    std::vector<float> averageSpectrumDb(const juce::AudioBuffer<float>& audio, int order)
+    {
+        const int size = 1 << order;
+        juce::dsp::FFT fft(order);
+        juce::dsp::WindowingFunction<float> window((size_t) size, juce::dsp::WindowingFunction<float>::hann);
+
+        std::vector<float> datos((size_t) (2 * size));
+        std::vector<double> suma((size_t) (size / 2), 0.0);
+        int numFrames = 0;
+
+        for (int pos = 0; pos + size <= audio.getNumSamples(); pos += size / 2, numFrames++) {
+            std::fill(datos.begin(), datos.end(), 0.0f);
+            std::copy(audio.getReadPointer(0, pos), audio.getReadPointer(0, pos) + size, datos.begin());
+            window.multiplyWithWindowingTable(datos.data(), (size_t) size);
+            fft.performFrequencyOnlyForwardTransform(datos.data());
+
+            for (size_t b = 0; b < suma.size(); b++)
+                suma[b] += (double) datos[b] * datos[b];
+        }
+
+        std::vector<float> db(suma.size());
+        for (size_t b = 0; b < suma.size(); b++)
+            db[b] = juce::Decibels::gainToDecibels((float) std::sqrt(suma[b] / juce::jmax(1, numFrames)) * 4.0f / (float) size, -160.0f);
+
+        return db;
+    }
+
+    double estimatePitch(const juce::AudioBuffer<float>& audio, double sampleRate, double minHz, double maxHz)
+    {
+        // Un único frame grande (con relleno de ceros) da resolución suficiente
+        // en frecuencia; la interpolación parabólica en dB afina el pico.
+        const int order = 17;
+        const int size = 1 << order;
+        const int n = juce::jmin(size, audio.getNumSamples());
+
+        juce::dsp::FFT fft(order);
+        juce::dsp::WindowingFunction<float> window((size_t) n, juce::dsp::WindowingFunction<float>::hann);
+
+        std::vector<float> datos((size_t) (2 * size), 0.0f);
+        std::copy(audio.getReadPointer(0), audio.getReadPointer(0) + n, datos.begin());
+        window.multiplyWithWindowingTable(datos.data(), (size_t) n);
+        fft.performFrequencyOnlyForwardTransform(datos.data());
+
+        const double hzPorBin = sampleRate / size;
+        const int desde = juce::jmax(1, (int) (minHz / hzPorBin));
+        const int hasta = juce::jmin(size / 2 - 2, (int) (maxHz / hzPorBin) + 1);
+
+        int pico = desde;
+        for (int b = desde; b <= hasta; b++)
+            if (datos[(size_t) b] > datos[(size_t) pico])
+                pico = b;
+
+        const double a = std::log(datos[(size_t) pico - 1] + 1.0e-20);
+        const double b = std::log(datos[(size_t) pico] + 1.0e-20);
+        const double c = std::log(datos[(size_t) pico + 1] + 1.0e-20);
+        const double denominador = a - 2.0 * b + c;
+        const double delta = denominador != 0.0 ? 0.5 * (a - c) / denominador : 0.0;
+
+        return (pico + juce::jlimit(-0.5, 0.5, delta)) * hzPorBin;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    TestUtils.h
+    Created: 19 Oct 2026
+
+    Render de secuencias MIDI con el SynthAudioProcessor y medidas sobre el
+    audio resultante (errores respecto a una referencia, espectro, pitch).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace test
+{
+    // Opciones de la línea de comandos de harpejji_tests
+    struct Config
+    {
+        juce::File goldenDir;
+        bool   updateGolden = false;
+        bool   requireGolden = false;              // Una referencia que falta es un fallo (si no, se omite)
+        bool   quick = false;
+        juce::File calibrationFile;                 // PitchCalibrationTables.h
+        bool   updateCalibration = false;           // Reescribe calibrationFile con lo que se mide
+        double sampleTolerance = 1.0e-4;            // Error máximo por sample (relativo al pico de la referencia)
+        double spectralToleranceDb = 0.5;           // Error medio del espectro en dB
+        double pitchToleranceCents = 1.0;           // Error de pitch en cents
+    };
+
+    Config& getConfig();
+
+    struct Nota
+    {
+        double inicio;                              // s
+        double duracion;                            // s
+        int    numero;
+        float  velocity;
+    };
+
+    struct Render
+    {
+        double sampleRate = 48000.0;
+        int    blockSize = 256;
+        double segundos = 2.0;
+        std::map<juce::String, float> parametros;   // TENSION, TONE, GAIN, SUSTAIN
+    };
+
+    // Devuelve el canal 0 de la salida del procesador
+    juce::AudioBuffer<float> render(const std::vector<Nota>& notas, const Render& r);
+
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate);
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate);
+
+    bool allFinite(const juce::AudioBuffer<float>& audio);
+
+    // Energía por ventanas (suma de cuadrados) de tamaño windowSize
+    std::vector<double> windowEnergy(const juce::AudioBuffer<float>& audio, int windowSize);
+
+    // Espectro de magnitud medio (dB) con ventanas de Hann de 2^order samples
+    std::vector<float> averageSpectrumDb(const juce::AudioBuffer<float>& audio, int order);
+
+    // Frecuencia del pico más fuerte entre minHz y maxHz (interpolación parabólica)
+    double estimatePitch(const juce::AudioBuffer<float>& audio, double sampleRate, double minHz, double maxHz);
+
+    inline double cents(double f, double ref) { return 1200.0 * std::log2(f / ref); }
+}
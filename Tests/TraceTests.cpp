@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    TraceTests.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "Trace.h"
+
+class TraceTests : public juce::UnitTest
+{
+public:
+    TraceTests() : juce::UnitTest("Trazas", "Harpejji") {}
+
+    void runTest() override
+    {
+       #if HARPEJJI_TRACE
+        beginTest("La traza es JSON válido con las fases del bloque");
+
+        const auto fichero = juce::File::createTempFile(".json");
+
+        {
+            SynthAudioProcessor processor;
+            processor.setRateAndBufferSizeDetails(48000.0, 256);
+            processor.prepareToPlay(48000.0, 256);
+
+            expect(trace::start(fichero));
+            expect(!trace::start(fichero), "Solo puede haber una traza a la vez");
+
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), 256);
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(1, 48, 0.8f), 10);
+
+            for (int b = 0; b < 20; b++) {
+                processor.processBlock(buffer, midi);
+                midi.clear();
+            }
+
+            trace::stop();
+            expect(!trace::isEnabled());
+        }
+
+        const auto json = juce::JSON::parse(fichero);
+        const auto* eventos = json["traceEvents"].getArray();
+        expect(eventos != nullptr);
+
+        if (eventos != nullptr) {
+            std::map<juce::String, int> cuenta;
+            for (const auto& e : *eventos)
+                if (e["ph"].toString() == "X")
+                    cuenta[e["name"].toString()]++;
+
+            expectEquals(cuenta["processBlock"], 20);
+            expectEquals(cuenta["filtro"], 20);
+            expectEquals(cuenta["noteOn"], 1);
+            expect(cuenta["voz"] >= 19);
+        }
+
+        fichero.deleteFile();
+
+        beginTest("Los hilos que terminan devuelven su buffer");
+        {
+            // Más hilos que buffers, uno detrás de otro, como un host que reinicia el dispositivo de audio
+            const auto otroFichero = juce::File::createTempFile(".json");
+            constexpr int numHilos = 48;
+
+            expect(trace::start(otroFichero));
+
+            for (int i = 0; i < numHilos; i++) {
+                std::thread([] { HARPEJJI_TRACE_SCOPE("hilo"); }).join();
+                juce::Thread::sleep(40);                // El escritor libera el buffer al vaciarlo
+            }
+
+            trace::stop();
+
+            const auto traza = juce::JSON::parse(otroFichero);
+            int eventosHilo = 0;
+            std::set<int> tids;
+
+            if (const auto* lista = traza["traceEvents"].getArray())
+                for (const auto& e : *lista)
+                    if (e["ph"].toString() == "X" && e["name"].toString() == "hilo") {
+                        eventosHilo++;
+                        tids.insert((int) e["tid"]);
+                    }
+
+            expectEquals(eventosHilo, numHilos);
+            expectEquals((int) tids.size(), numHilos);
+            expectEquals((int) traza["otherData"]["eventosSinBuffer"], 0);
+
+            otroFichero.deleteFile();
+        }
+       #endif
+    }
+};
+
+static TraceTests traceTests;
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    BenchUtils.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "BenchUtils.h"
+#include <map>
+#include <numeric>
+
+namespace bench
+{
+    Stats computeStats(std::vector<double> values)
+    {
+        Stats st;
+        if (values.empty())
+            return st;
+
+        std::sort(values.begin(), values.end());
+
+        auto percentile = [&](double p) {
+            return values[(size_t) juce::jlimit(0, (int) values.size() - 1, (int) std::ceil(p * (double) values.size()) - 1)];
+        };
+
+        st.mean = std::accumulate(values.begin(), values.end(), 0.0) / (double) values.size();
+        st.p50 = percentile(0.50);
+        st.p99 = percentile(0.99);
+        st.max = values.back();
+        return st;
+    }
+
+    juce::DynamicObject::Ptr makeCase(const juce::String& id)
+    {
+        juce::DynamicObject::Ptr c = new juce::DynamicObject();
+        c->setProperty("id", id);
+        return c;
+    }
+
+    void addCounters(juce::DynamicObject& c, const PerfCounters* counters, double numSamples)
+    {
+        const bool disponible = counters != nullptr && counters->isAvailable();
+        c.setProperty("counters", disponible);
+
+        if (!disponible)
+            return;
+
+        for (int i = 0; i < PerfCounters::numCounters; i++) {
+            const double valor = counters->get(i);
+            if (valor < 0.0)
+                continue;
+
+            c.setProperty(PerfCounters::getName(i), valor);
+            c.setProperty(juce::String(PerfCounters::getName(i)) + "_per_sample", valor / juce::jmax(1.0, numSamples));
+        }
+
+        const double ciclos = counters->get(PerfCounters::cycles);
+        if (ciclos > 0.0)
+            c.setProperty("ipc", counters->get(PerfCounters::instructions) / ciclos);
+    }
+
+    void writeResults(const juce::String& name, const juce::Array<juce::var>& cases, const juce::File& file)
+    {
+        juce::DynamicObject::Ptr root = new juce::DynamicObject();
+        root->setProperty("benchmark", name);
+        root->setProperty("cases", cases);
+
+        const auto json = juce::JSON::toString(juce::var(root.get()));
+
+        if (file == juce::File())
+            std::cout << json << std::endl;
+        else
+            file.replaceWithText(json);
+    }
+
+    int compareWithBaseline(const juce::Array<juce::var>& cases, const juce::File& baseline,
+                            const juce::StringArray& metrics, double thresholdPercent)
+    {
+        const auto parsed = juce::JSON::parse(baseline);
+        const auto* baseCases = parsed["cases"].getArray();
+
+        if (baseCases == nullptr) {
+            std::cerr << "linea base no valida: " << baseline.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        std::map<juce::String, juce::var> porId;
+        for (const auto& c : *baseCases)
+            porId[c["id"].toString()] = c;
+
+        int regresiones = 0;
+
+        for (const auto& c : cases) {
+            const auto it = porId.find(c["id"].toString());
+            if (it == porId.end())
+                continue;
+
+            for (const auto& m : metrics) {
+                const double antes = it->second[juce::Identifier(m)];
+                const double ahora = c[juce::Identifier(m)];
+
+                if (antes <= 0.0)
+                    continue;
+
+                const double cambio = 100.0 * (ahora - antes) / antes;
+                if (cambio > thresholdPercent) {
+                    std::cerr << "REGRESION " << c["id"].toString() << " " << m << ": "
+                              << antes << " -> " << ahora << " (+" << juce::String(cambio, 1) << " %)" << std::endl;
+                    regresiones++;
+                }
+            }
+        }
+
+        return regresiones;
+    }
+
+    int finish(const juce::String& name, const juce::Array<juce::var>& cases,
+               const juce::ArgumentList& args, const juce::StringArray& metrics)
+    {
+        juce::File output;
+        if (args.containsOption("--output"))
+            output = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        writeResults(name, cases, output);
+
+        if (!args.containsOption("--baseline"))
+            return 0;
+
+        const double umbral = args.containsOption("--threshold") ? args.getValueForOption("--threshold").getDoubleValue() : 10.0;
+        const auto baseline = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--baseline"));
+        const int regresiones = compareWithBaseline(cases, baseline, metrics, umbral);
+
+        std::cerr << regresiones << " regresiones (umbral " << umbral << " %)" << std::endl;
+        return regresiones == 0 ? 0 : 1;
+    }
+}
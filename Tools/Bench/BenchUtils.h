@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    BenchUtils.h
+    Created: 19 Oct 2026
+
+    Utilidades comunes de los benchmarks: tiempos, estadísticas, salida JSON
+    y comparación con una línea base guardada.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerfCounters.h"
+
+namespace bench
+{
+    inline double nowNs() noexcept
+    {
+        return 1.0e9 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks());
+    }
+
+    struct Stats
+    {
+        double mean = 0.0, p50 = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    Stats computeStats(std::vector<double> values);
+
+    // Un caso de benchmark es un objeto JSON con un "id" único y sus métricas
+    juce::DynamicObject::Ptr makeCase(const juce::String& id);
+
+    // Añade al caso los contadores hardware acumulados: totales, por sample e IPC.
+    // Si los contadores no están disponibles solo se añade "counters": false.
+    void addCounters(juce::DynamicObject& c, const PerfCounters* counters, double numSamples);
+
+    // Escribe {"benchmark": name, "cases": [...]} en el fichero (o en stdout si no hay fichero)
+    void writeResults(const juce::String& name, const juce::Array<juce::var>& cases, const juce::File& file);
+
+    // Compara las métricas indicadas con las de la línea base (mismo "id").
+    // Devuelve el número de casos que son más lentos que el umbral (en %).
+    int compareWithBaseline(const juce::Array<juce::var>& cases, const juce::File& baseline,
+                            const juce::StringArray& metrics, double thresholdPercent);
+
+    // Opciones comunes: --output fichero.json --baseline fichero.json --threshold 10
+    int finish(const juce::String& name, const juce::Array<juce::var>& cases,
+               const juce::ArgumentList& args, const juce::StringArray& metrics);
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    EditorBenchmark.cpp
+    Created: 19 Oct 2026
+
+    Coste de pintar el editor en el hilo de mensajes (se repinta a 60 Hz). Se
+    construye el SynthAudioProcessorEditor, se le dan instantáneas sintéticas
+    de 0 a 16 cuerdas activas y se mide paint() sobre una juce::Image con el
+    renderizador software, sin ventana ni pantalla. Antes se mide la apertura
+    del editor (hasta que el fondo está decodificado), la primera y otra
+    después de cerrarlo, y la memoria de las imágenes del fondo.
+
+  ==============================================================================
+*/
+
+#include "BenchUtils.h"
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "BackgroundImage.h"
+
+namespace
+{
+    void setSnapshot(SynthAudioProcessor& processor, int numActivas, double fase)
+    {
+        std::vector<int> cuerdas, trastes;
+        std::vector<std::vector<float>> visual;
+
+        for (int i = 0; i < numActivas; i++) {
+            // Tamaño de malla parecido al de una nota real a 48 kHz (cuerdas graves más largas)
+            const int X = 360 - 18 * i;
+            std::vector<float> forma((size_t) (X + 1), 0.0f);
+
+            for (int x = 0; x <= X; x++)
+                forma[(size_t) x] = (float) (1.0e-3 * std::sin(juce::MathConstants<double>::pi * x / X) * std::cos(fase + i)
+                                           + 3.0e-4 * std::sin(3.0 * juce::MathConstants<double>::pi * x / X) * std::cos(3.0 * fase));
+
+            cuerdas.push_back(i);
+            trastes.push_back(1 + i % 5);
+            visual.push_back(std::move(forma));
+        }
+
+        processor.setVisualSnapshot(cuerdas, trastes, visual);
+    }
+
+    juce::var runCase(SynthAudioProcessorEditor& editor, SynthAudioProcessor& processor, int numActivas,
+                      float escala, bool conHijos, int numFrames)
+    {
+        juce::Image imagen(juce::Image::ARGB, juce::roundToInt(editor.getWidth() * escala),
+                           juce::roundToInt(editor.getHeight() * escala), true, juce::SoftwareImageType());
+
+        std::vector<double> tiempos;
+
+        for (int f = 0; f < numFrames + 1; f++) {
+            setSnapshot(processor, numActivas, 0.3 * f);
+
+            juce::Graphics g(imagen);
+            g.addTransform(juce::AffineTransform::scale(escala));
+
+            const double t0 = bench::nowNs();
+            if (conHijos)
+                editor.paintEntireComponent(g, false);
+            else
+                editor.paint(g);
+            const double t = bench::nowNs() - t0;
+
+            if (f > 0)
+                tiempos.push_back(t);
+        }
+
+        const auto st = bench::computeStats(tiempos);
+        const double frame = 1.0e9 / 60.0;
+
+        auto c = bench::makeCase("strings" + juce::String(numActivas) + "_x" + juce::String(escala, 0)
+                                 + (conHijos ? "_all" : "_paint"));
+        c->setProperty("active_strings", numActivas);
+        c->setProperty("scale", escala);
+        c->setProperty("children", conHijos);
+        c->setProperty("mean_ns", st.mean);
+        c->setProperty("p99_ns", st.p99);
+        c->setProperty("max_ns", st.max);
+        c->setProperty("frame_load", st.mean / frame);
+        return juce::var(c.get());
+    }
+}
+
+int runEditorBenchmark(const juce::ArgumentList& args)
+{
+    const int numFrames = args.containsOption("--frames") ? args.getValueForOption("--frames").getIntValue() : 120;
+
+    SynthAudioProcessor::setEditorFactory(&SynthAudioProcessorEditor::create);
+
+    SynthAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(48000.0, 256);
+    processor.prepareToPlay(48000.0, 256);
+
+    juce::Array<juce::var> resultados;
+
+    // Apertura del editor: la primera decodifica el fondo en otro hilo; después de cerrar el
+    // último editor, la siguiente reutiliza las imágenes ya decodificadas
+    for (const char* apertura : { "open_first", "open_again" }) {
+        const double t0 = bench::nowNs();
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+        const double construido = bench::nowNs() - t0;
+
+        double fondoListo = 0.0;
+        {
+            juce::SharedResourcePointer<BackgroundImage> fondo;
+            while (!fondo->isReady() && bench::nowNs() - t0 < 5.0e9)
+                juce::Thread::sleep(1);
+            fondoListo = bench::nowNs() - t0;
+        }
+
+        auto c = bench::makeCase(apertura);
+        c->setProperty("construct_ns", construido);
+        c->setProperty("background_ready_ns", fondoListo);
+        c->setProperty("background_bytes", BackgroundImage::getDecodedBytes());
+        resultados.add(juce::var(c.get()));
+    }
+
+    std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+    auto* harpejji = dynamic_cast<SynthAudioProcessorEditor*>(editor.get());
+    jassert(harpejji != nullptr);
+
+    for (float escala : { 1.0f, 2.0f })
+        for (bool conHijos : { false, true })
+            for (int numActivas = 0; numActivas <= 16; numActivas++)
+                resultados.add(runCase(*harpejji, processor, numActivas, escala, conHijos, numFrames));
+
+    return bench::finish("editor", resultados, args, { "mean_ns", "p99_ns" });
+}
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    HostBenchmark.cpp
+    Created: 19 Oct 2026
+
+    Simulación de host: se crea el SynthAudioProcessor, se llama a prepareToPlay
+    y se reproducen secuencias MIDI realistas a través de processBlock mientras
+    se automatizan TONE, GAIN, TENSION y SUSTAIN como lo haría un host. Lo que
+    importa es el peor bloque, que es el que provoca los cortes de audio.
+
+  ==============================================================================
+*/
+
+#include "BenchUtils.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct Evento
+    {
+        int64_t sample;
+        juce::MidiMessage mensaje;
+    };
+
+    using Corpus = std::vector<Evento>;
+
+    void nota(Corpus& c, double sr, double inicio, double duracion, int numero, float velocity)
+    {
+        c.push_back({ (int64_t) (inicio * sr), juce::MidiMessage::noteOn(1, numero, velocity) });
+        c.push_back({ (int64_t) ((inicio + duracion) * sr), juce::MidiMessage::noteOff(1, numero) });
+    }
+
+    // Arpegios de corcheas a 120 bpm sobre una progresión de cuatro acordes
+    Corpus arpegios(double sr, double segundos, juce::Random& rnd)
+    {
+        const int acordes[4][4] = { { 48, 52, 55, 60 }, { 45, 48, 52, 57 }, { 41, 45, 48, 53 }, { 43, 47, 50, 55 } };
+        Corpus c;
+        int paso = 0;
+        for (double t = 0.0; t < segundos; t += 0.25, paso++) {
+            const auto& acorde = acordes[(paso / 8) % 4];
+            nota(c, sr, t, 0.4, acorde[paso % 4] + 12 * ((paso / 4) % 2), 0.5f + 0.4f * rnd.nextFloat());
+        }
+        return c;
+    }
+
+    // Acordes rasgueados de 6 a 10 notas (15 ms entre cuerdas) cada 2 s
+    Corpus rasgueos(double sr, double segundos, juce::Random& rnd)
+    {
+        Corpus c;
+        for (double t = 0.0; t < segundos; t += 2.0) {
+            const int numNotas = 6 + rnd.nextInt(5);
+            const int raiz = 40 + rnd.nextInt(8);
+            for (int i = 0; i < numNotas; i++)
+                nota(c, sr, t + 0.015 * i, 1.8, juce::jmin(84, raiz + 3 * i + (i % 2)), 0.6f + 0.4f * rnd.nextFloat());
+        }
+        return c;
+    }
+
+    // Notas repetidas rápidas (trémolo de 16 Hz) saltando entre tres notas
+    Corpus repetidas(double sr, double segundos, juce::Random& rnd)
+    {
+        Corpus c;
+        const int numeros[] = { 60, 67, 72 };
+        int i = 0;
+        for (double t = 0.0; t < segundos; t += 1.0 / 16.0, i++)
+            nota(c, sr, t, 0.05, numeros[(i / 16) % 3], 0.7f + 0.3f * rnd.nextFloat());
+        return c;
+    }
+
+    // Pads: acordes de seis notas sostenidos 4 s, solapándose con el siguiente
+    Corpus pads(double sr, double segundos, juce::Random& rnd)
+    {
+        Corpus c;
+        for (double t = 0.0; t < segundos; t += 4.0) {
+            const int raiz = 36 + rnd.nextInt(12);
+            for (int i : { 0, 7, 12, 16, 19, 24 })
+                nota(c, sr, t, 4.5, raiz + i, 0.8f);
+        }
+        return c;
+    }
+
+    // Automatización tipo host: cada parámetro sigue un LFO lento distinto
+    void automatizar(SynthAudioProcessor& processor, double segundo)
+    {
+        const char* ids[]  = { "TONE", "GAIN", "TENSION", "SUSTAIN" };
+        const double hz[] = { 0.13, 0.07, 0.05, 0.11 };
+
+        for (int i = 0; i < 4; i++)
+            if (auto* p = processor.apvts.getParameter(ids[i]))
+                p->setValueNotifyingHost((float) (0.5 + 0.45 * std::sin(juce::MathConstants<double>::twoPi * hz[i] * segundo)));
+    }
+
+    juce::var runScenario(const juce::String& nombre, Corpus corpus, double sr, int blockSize, double segundos,
+                          bool automatizacion, PerfCounters* counters)
+    {
+        std::sort(corpus.begin(), corpus.end(), [](const Evento& a, const Evento& b) { return a.sample < b.sample; });
+
+        SynthAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sr, blockSize);
+        processor.prepareToPlay(sr, blockSize);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        const int64_t numSamples = (int64_t) (segundos * sr);
+        size_t siguiente = 0;
+        std::vector<double> tiempos;
+
+        if (counters != nullptr)
+            counters->reset();
+
+        for (int64_t inicio = 0; inicio < numSamples; inicio += blockSize) {
+            midi.clear();
+            while (siguiente < corpus.size() && corpus[siguiente].sample < inicio + blockSize) {
+                midi.addEvent(corpus[siguiente].mensaje, (int) juce::jmax<int64_t>(0, corpus[siguiente].sample - inicio));
+                siguiente++;
+            }
+
+            if (automatizacion)
+                automatizar(processor, (double) inicio / sr);
+
+            if (counters != nullptr)
+                counters->start();
+
+            const double t0 = bench::nowNs();
+            processor.processBlock(buffer, midi);
+            tiempos.push_back(bench::nowNs() - t0);
+
+            if (counters != nullptr)
+                counters->stop();
+        }
+
+        const auto st = bench::computeStats(tiempos);
+        const double presupuesto = 1.0e9 * blockSize / sr;
+
+        auto c = bench::makeCase(nombre + "_sr" + juce::String((int) sr) + "_bs" + juce::String(blockSize)
+                                 + (automatizacion ? "_auto" : ""));
+        c->setProperty("scenario", nombre);
+        c->setProperty("sample_rate", sr);
+        c->setProperty("block_size", blockSize);
+        c->setProperty("automation", automatizacion);
+        c->setProperty("blocks", (int) tiempos.size());
+        c->setProperty("mean_ns", st.mean);
+        c->setProperty("p99_ns", st.p99);
+        c->setProperty("max_ns", st.max);
+        c->setProperty("budget_ns", presupuesto);
+        c->setProperty("mean_load", st.mean / presupuesto);
+        c->setProperty("p99_load", st.p99 / presupuesto);
+        c->setProperty("max_load", st.max / presupuesto);
+        bench::addCounters(*c, counters, (double) tiempos.size() * blockSize);
+        return juce::var(c.get());
+    }
+}
+
+int runHostBenchmark(const juce::ArgumentList& args)
+{
+    const double segundos = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 20.0;
+    const bool completo = args.containsOption("--full");
+
+    std::unique_ptr<PerfCounters> counters;
+    if (args.containsOption("--counters")) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->isAvailable())
+            std::cerr << "contadores hardware no disponibles: solo tiempos" << std::endl;
+    }
+
+    std::vector<double> sampleRates { 48000.0 };
+    std::vector<int> blockSizes { 256 };
+    if (completo) {
+        sampleRates = { 44100.0, 48000.0, 96000.0 };
+        blockSizes = { 64, 256, 512, 1024 };
+    }
+
+    using Generador = Corpus (*)(double, double, juce::Random&);
+    const std::pair<const char*, Generador> escenarios[] = {
+        { "arpeggio", arpegios }, { "strum", rasgueos }, { "repeated", repetidas }, { "pads", pads }
+    };
+
+    juce::Array<juce::var> resultados;
+
+    for (const auto& e : escenarios)
+        for (double sr : sampleRates)
+            for (int bs : blockSizes)
+                for (bool automatizacion : { false, true }) {
+                    juce::Random rnd(1234);         // Misma secuencia en todas las ejecuciones
+                    resultados.add(runScenario(e.first, e.second(sr, segundos, rnd), sr, bs, segundos, automatizacion, counters.get()));
+                }
+
+    return bench::finish("host", resultados, args, { "mean_ns", "p99_ns" });
+}
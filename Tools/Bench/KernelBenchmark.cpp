@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.cpp
+    Created: 19 Oct 2026
+
+    Benchmark del núcleo de la cuerda: SynthVoice::setInitialConditions (note on)
+    y SynthVoice::renderNextBlock, llamados directamente sin el procesador.
+
+  ==============================================================================
+*/
+
+#include "BenchUtils.h"
+#include "SynthVoice.h"
+
+namespace
+{
+    struct KernelCase
+    {
+        int    nota;
+        float  velocity;
+        float  tension;
+        double sampleRate;
+        int    blockSize;
+    };
+
+    const int    notas[]        = { 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+                                    53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69,
+                                    70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84 };    // 65.4 - 1046.5 Hz
+    const float  velocities[]   = { 0.2f, 0.6f, 1.0f };
+    const float  tensiones[]    = { 0.1f, 0.4f, 0.7f, 1.0f, 1.4f };
+    const double sampleRates[]  = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const int    blockSizes[]   = { 16, 64, 256, 1024, 2048 };
+
+    const KernelCase porDefecto { 60, 0.8f, 1.0f, 48000.0, 256 };
+
+    juce::String caseId(const KernelCase& k)
+    {
+        return "note" + juce::String(k.nota) + "_vel" + juce::String(k.velocity, 1) + "_t" + juce::String(k.tension, 1)
+             + "_sr" + juce::String((int) k.sampleRate) + "_bs" + juce::String(k.blockSize);
+    }
+
+    // Por defecto se barre cada dimensión por separado alrededor del caso por
+    // defecto; con --full se recorre el producto cartesiano completo.
+    std::vector<KernelCase> buildCases(bool completo)
+    {
+        std::vector<KernelCase> casos;
+
+        if (completo) {
+            for (int n : notas) for (float v : velocities) for (float t : tensiones)
+                for (double sr : sampleRates) for (int bs : blockSizes)
+                    casos.push_back({ n, v, t, sr, bs });
+            return casos;
+        }
+
+        for (int n : notas)         { auto k = porDefecto; k.nota = n;        casos.push_back(k); }
+        for (float v : velocities)  { auto k = porDefecto; k.velocity = v;    casos.push_back(k); }
+        for (float t : tensiones)   { auto k = porDefecto; k.tension = t;     casos.push_back(k); }
+        for (double sr : sampleRates) { auto k = porDefecto; k.sampleRate = sr; casos.push_back(k); }
+        for (int bs : blockSizes)   { auto k = porDefecto; k.blockSize = bs;  casos.push_back(k); }
+
+        return casos;
+    }
+
+    juce::var runCase(const KernelCase& k, double segundos, PerfCounters* counters)
+    {
+        // Se usa un Synthesiser de una sola voz para que la voz quede activa
+        // (SynthesiserVoice::isVoiceActive); después se llama a la voz directamente.
+        juce::Synthesiser synth;
+        auto* voice = new SynthVoice();
+        synth.addVoice(voice);
+        synth.addSound(new SynthSound());
+        synth.setCurrentPlaybackSampleRate(k.sampleRate);
+        voice->prepareToPlay(k.sampleRate, k.blockSize, 1);
+        voice->updateParams(k.tension, 1.0f);
+
+        const double frecuencia = juce::MidiMessage::getMidiNoteInHertz(k.nota);
+
+        // Note on: mediana de varias llamadas a setInitialConditions
+        std::vector<double> noteOn;
+        for (int i = 0; i < 21; i++) {
+            const double t0 = bench::nowNs();
+            voice->setInitialConditions(k.velocity, frecuencia);
+            noteOn.push_back(bench::nowNs() - t0);
+        }
+
+        synth.noteOn(1, k.nota, k.velocity);
+
+        juce::AudioBuffer<float> buffer(1, k.blockSize);
+        const int numBlocks = juce::jmax(8, (int) (segundos * k.sampleRate / k.blockSize));
+
+        double total = 0.0;
+        int64_t samples = 0;
+        int retriggers = 0;
+
+        if (counters != nullptr)
+            counters->reset();
+
+        for (int b = 0; b < numBlocks + 1; b++) {
+            // Si el detector de silencio apaga la voz se vuelve a pulsar (fuera de la medida)
+            if (!voice->isVoiceActive()) {
+                synth.noteOn(1, k.nota, k.velocity);
+                retriggers++;
+            }
+
+            buffer.clear();
+
+            const bool medir = b > 0 && counters != nullptr;
+            if (medir)
+                counters->start();
+
+            const double t0 = bench::nowNs();
+            voice->renderNextBlock(buffer, 0, k.blockSize);
+            const double t = bench::nowNs() - t0;
+
+            if (medir)
+                counters->stop();
+
+            if (b > 0) {                            // El primer bloque calienta caches
+                total += t;
+                samples += k.blockSize;
+            }
+        }
+
+        const int X = juce::jmax(1, voice->getNumPuntos());
+        const double nsPorSample = total / (double) juce::jmax<int64_t>(1, samples);
+
+        auto c = bench::makeCase(caseId(k));
+        c->setProperty("note", k.nota);
+        c->setProperty("frequency", frecuencia);
+        c->setProperty("velocity", k.velocity);
+        c->setProperty("tension", k.tension);
+        c->setProperty("sample_rate", k.sampleRate);
+        c->setProperty("block_size", k.blockSize);
+        c->setProperty("grid_points", X);
+        c->setProperty("ns_per_sample", nsPorSample);
+        c->setProperty("ns_per_grid_point", nsPorSample / X);
+        c->setProperty("note_on_ns", bench::computeStats(noteOn).p50);
+        c->setProperty("retriggers", retriggers);
+        bench::addCounters(*c, counters, (double) samples);
+        return juce::var(c.get());
+    }
+}
+
+int runKernelBenchmark(const juce::ArgumentList& args)
+{
+    const bool completo = args.containsOption("--full");
+    const double segundos = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 0.25;
+
+    std::unique_ptr<PerfCounters> counters;
+    if (args.containsOption("--counters")) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->isAvailable())
+            std::cerr << "contadores hardware no disponibles: solo tiempos" << std::endl;
+    }
+
+    juce::Array<juce::var> resultados;
+    const auto casos = buildCases(completo);
+
+    for (size_t i = 0; i < casos.size(); i++) {
+        resultados.add(runCase(casos[i], segundos, counters.get()));
+        std::cerr << "\r" << (i + 1) << "/" << casos.size() << std::flush;
+    }
+    std::cerr << std::endl;
+
+    // grid_points no depende de la máquina: con cualquier línea base detecta una malla más fina
+    return bench::finish("kernel", resultados, args, { "ns_per_sample", "note_on_ns", "grid_points" });
+}
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    Main.cpp (harpejji_bench)
+    Created: 19 Oct 2026
+
+    harpejji_bench <kernel|host|editor> [--output res.json] [--baseline base.json] [--threshold 10]
+
+  ==============================================================================
+*/
+
+#include "BenchUtils.h"
+
+int runKernelBenchmark(const juce::ArgumentList& args);
+int runHostBenchmark(const juce::ArgumentList& args);
+int runEditorBenchmark(const juce::ArgumentList& args);
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const juce::ArgumentList args(argc, argv);
+    const auto modo = args.size() > 0 ? args[0].text : juce::String("kernel");
+
+    if (modo == "kernel")
+        return runKernelBenchmark(args);
+
+    if (modo == "host")
+        return runHostBenchmark(args);
+
+    if (modo == "editor")
+        return runEditorBenchmark(args);
+
+    std::cerr << "uso: harpejji_bench <kernel|host|editor> [--full] [--seconds s] [--counters] [--output res.json]"
+                 " [--baseline base.json] [--threshold %]" << std::endl;
+    return 1;
+}
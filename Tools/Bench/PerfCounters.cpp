@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    PerfCounters.cpp
+    Created: 19 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PerfCounters.h"
+
+#if defined (__linux__)
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <cstring>
+#endif
+
+#if defined (__linux__)
+namespace
+{
+    int openCounter(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    uint64_t cacheConfig(uint64_t cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+}
+#endif
+
+PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+
+   #if defined (__linux__)
+    fds[cycles]       = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[instructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[l1dMisses]    = openCounter(PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D));
+    fds[llcMisses]    = openCounter(PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_LL));
+    fds[branchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+    // Con ciclos e instrucciones basta para considerar que hay contadores; el
+    // resto puede faltar según la CPU y se informa como -1
+    available = fds[cycles] >= 0 && fds[instructions] >= 0;
+   #endif
+}
+
+PerfCounters::~PerfCounters()
+{
+   #if defined (__linux__)
+    for (int fd : fds)
+        if (fd >= 0)
+            close(fd);
+   #endif
+}
+
+const char* PerfCounters::getName(int counter) noexcept
+{
+    switch (counter) {
+        case cycles:        return "cycles";
+        case instructions:  return "instructions";
+        case l1dMisses:     return "l1d_misses";
+        case llcMisses:     return "llc_misses";
+        case branchMisses:  return "branch_misses";
+        default:            return "";
+    }
+}
+
+void PerfCounters::start() noexcept
+{
+   #if defined (__linux__)
+    for (int fd : fds)
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+   #endif
+}
+
+void PerfCounters::stop() noexcept
+{
+   #if defined (__linux__)
+    for (int fd : fds)
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int i = 0; i < numCounters; i++) {
+        if (fds[(size_t) i] < 0)
+            continue;
+
+        uint64_t valores[3] = {};                   // valor, tiempo activado, tiempo contando
+        if (read(fds[(size_t) i], valores, sizeof(valores)) != (ssize_t) sizeof(valores))
+            continue;
+
+        const double escala = valores[2] > 0 ? (double) valores[1] / (double) valores[2] : 1.0;
+        totales[(size_t) i] += (double) valores[0] * escala;
+    }
+   #endif
+}
+
+void PerfCounters::reset() noexcept
+{
+    totales.fill(0.0);
+}
+
+double PerfCounters::get(int counter) const noexcept
+{
+    if (counter < 0 || counter >= numCounters || fds[(size_t) counter] < 0)
+        return -1.0;
+
+    return totales[(size_t) counter];
+}
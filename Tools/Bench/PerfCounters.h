@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    PerfCounters.h
+    Created: 19 Oct 2026
+
+    Contadores hardware (ciclos, instrucciones, fallos de L1/LLC y de predicción
+    de saltos) mediante perf_event_open en Linux. Si el sistema no los permite
+    (otro SO, perf_event_paranoid, máquina virtual sin PMU...) isAvailable()
+    devuelve false y los benchmarks se quedan solo con los tiempos.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        cycles = 0,
+        instructions,
+        l1dMisses,
+        llcMisses,
+        branchMisses,
+        numCounters
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    bool isAvailable() const noexcept { return available; }
+    static const char* getName(int counter) noexcept;
+
+    // Acumulan entre start() y stop(); reset() pone los totales a 0
+    void start() noexcept;
+    void stop() noexcept;
+    void reset() noexcept;
+
+    // Valor acumulado (escalado si el kernel ha multiplexado los contadores), -1 si no está disponible
+    double get(int counter) const noexcept;
+
+private:
+    std::array<int, numCounters> fds;
+    std::array<double, numCounters> totales {};
+    bool available = false;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+};
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    Main.cpp (harpejji_monitor)
+    Created: 19 Oct 2026
+
+    Lee las métricas que publica un SynthAudioProcessor arrancado con
+    HARPEJJI_SHM=<nombre> (ver Source/SharedMetrics.h) y las imprime cada
+    cierto intervalo. Solo lee la memoria compartida: no interactúa con el
+    proceso monitorizado.
+
+    harpejji_monitor <nombre> [--interval ms] [--count n] [--csv]
+
+  ==============================================================================
+*/
+
+#include "SharedMetrics.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+int main(int argc, char* argv[])
+{
+   #if JUCE_LINUX || JUCE_MAC
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.size() < 1 || args[0].isOption()) {
+        std::cerr << "uso: harpejji_monitor <nombre> [--interval ms] [--count n] [--csv]" << std::endl;
+        return 2;
+    }
+
+    const auto nombre = args[0].text.startsWithChar('/') ? args[0].text : "/" + args[0].text;
+    const int intervalo = args.containsOption("--interval") ? juce::jmax(1, args.getValueForOption("--interval").getIntValue()) : 1000;
+    const int numLecturas = args.containsOption("--count") ? args.getValueForOption("--count").getIntValue() : 0;
+    const bool csv = args.containsOption("--csv");
+
+    const int fd = shm_open(nombre.toRawUTF8(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "no existe el segmento " << nombre << std::endl;
+        return 1;
+    }
+
+    void* p = mmap(nullptr, sizeof(SharedMetrics::Layout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED) {
+        std::cerr << "no se pudo mapear " << nombre << std::endl;
+        return 1;
+    }
+
+    const auto& layout = *static_cast<const SharedMetrics::Layout*>(p);
+
+    if (csv)
+        std::cout << "ms,pid,bloques,carga,carga_max,voces,xruns,silenciadas,perdidas,inestables,enmascaradas,enmascaramiento,calidad,bloque,sample_rate,antiguedad_ms" << std::endl;
+
+    SharedMetrics::Payload m;
+
+    for (int i = 0; numLecturas <= 0 || i < numLecturas; i++) {
+        if (i > 0)
+            juce::Thread::sleep(intervalo);
+
+        if (!SharedMetrics::read(layout, m)) {
+            std::cerr << "lectura incoherente o versión distinta" << std::endl;
+            continue;
+        }
+
+        // Un proceso colgado (o sin audio) deja de actualizar updateMs
+        const auto ahora = juce::Time::getMillisecondCounter();
+        const auto antiguedad = m.updateMs != 0 ? (juce::int64) (ahora - m.updateMs) : -1;
+
+        if (csv) {
+            std::cout << ahora << ',' << layout.pid << ',' << m.numBlocks << ',' << m.load << ',' << m.maxLoad << ','
+                      << m.activeVoices << ',' << m.xruns << ',' << m.voicesSilenced << ',' << m.droppedNotes << ',' << m.voicesQuarantined << ','
+                      << m.voicesMasked << ',' << m.maskingAggressiveness << ','
+                      << m.qualityTier << ',' << m.blockSize << ',' << m.sampleRate << ',' << antiguedad << std::endl;
+        }
+        else {
+            std::cout << "pid " << layout.pid
+                      << "  carga " << juce::String(100.0f * m.load, 1) << " % (max " << juce::String(100.0f * m.maxLoad, 1) << " %)"
+                      << "  voces " << m.activeVoices
+                      << "  xruns " << m.xruns
+                      << "  silenciadas " << m.voicesSilenced
+                      << "  perdidas " << m.droppedNotes
+                      << "  inestables " << m.voicesQuarantined
+                      << "  enmascaradas " << m.voicesMasked << " (" << juce::String(m.maskingAggressiveness, 2) << ")"
+                      << "  calidad " << m.qualityTier
+                      << "  bloque " << m.blockSize << " @ " << m.sampleRate
+                      << "  hace " << antiguedad << " ms" << std::endl;
+        }
+    }
+
+    munmap(p, sizeof(SharedMetrics::Layout));
+    return 0;
+   #else
+    juce::ignoreUnused(argc, argv);
+    std::cerr << "harpejji_monitor solo funciona en Linux y macOS" << std::endl;
+    return 1;
+   #endif
+}
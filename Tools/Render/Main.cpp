@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    Main.cpp (harpejji_render)
+    Created: 19 Oct 2026
+
+    Render offline de ficheros MIDI (o de un directorio de ficheros MIDI) a
+    WAV/FLAC con el SynthAudioProcessor, más rápido que tiempo real. En modo
+    batch se lanza un trabajo por núcleo, cada uno con su propio procesador.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct Opciones
+    {
+        double sampleRate = 48000.0;
+        int    blockSize = 512;
+        int    bits = 24;
+        int    calidad = 0;                         // Índice de calidad del formato (nivel de compresión en FLAC)
+        bool   flac = false;
+        double cola = 3.0;                          // Segundos que se renderizan tras el último evento
+        float  pisoSilencio = SynthVoice::pisoSilencioDefecto;     // dBFS
+        float  enmascaramiento = 0.0f;              // Agresividad del culling por enmascaramiento (0: desactivado)
+        std::map<juce::String, float> parametros;   // TENSION, TONE, GAIN, SUSTAIN
+    };
+
+    struct Resultado
+    {
+        bool ok = false;
+        double segundosAudio = 0.0;
+        double segundosRender = 0.0;
+        juce::String error;
+    };
+
+    bool leerMidi(const juce::File& fichero, juce::MidiMessageSequence& secuencia)
+    {
+        juce::FileInputStream in(fichero);
+        juce::MidiFile midiFile;
+
+        if (!in.openedOk() || !midiFile.readFrom(in))
+            return false;
+
+        midiFile.convertTimestampTicksToSeconds();
+
+        for (int t = 0; t < midiFile.getNumTracks(); t++)
+            secuencia.addSequence(*midiFile.getTrack(t), 0.0);
+
+        secuencia.updateMatchedPairs();
+        return true;
+    }
+
+    Resultado renderizar(const juce::File& entrada, const juce::File& salida, const Opciones& op)
+    {
+        Resultado r;
+        const auto inicio = juce::Time::getMillisecondCounterHiRes();
+
+        juce::MidiMessageSequence secuencia;
+        if (!leerMidi(entrada, secuencia)) {
+            r.error = "no se puede leer " + entrada.getFullPathName();
+            return r;
+        }
+
+        SynthAudioProcessor processor;
+
+        for (const auto& p : op.parametros)
+            if (auto* param = processor.apvts.getParameter(p.first))
+                param->setValueNotifyingHost(param->convertTo0to1(p.second));
+
+        processor.setSilenceFloorDb(op.pisoSilencio);
+        processor.setMaskingCulling(op.enmascaramiento);
+        processor.setRateAndBufferSizeDetails(op.sampleRate, op.blockSize);
+        processor.prepareToPlay(op.sampleRate, op.blockSize);
+
+        const int numChannels = processor.getTotalNumOutputChannels();
+        juce::AudioBuffer<float> buffer(numChannels, op.blockSize);
+        juce::MidiBuffer midi;
+
+        salida.deleteFile();
+        std::unique_ptr<juce::AudioFormat> formato;
+        if (op.flac)
+            formato = std::make_unique<juce::FlacAudioFormat>();
+        else
+            formato = std::make_unique<juce::WavAudioFormat>();
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(formato->createWriterFor(new juce::FileOutputStream(salida), op.sampleRate,
+                                                                                 (unsigned int) numChannels, op.bits, {}, op.calidad));
+        if (writer == nullptr) {
+            r.error = "no se puede escribir " + salida.getFullPathName();
+            return r;
+        }
+
+        const double duracion = secuencia.getEndTime() + op.cola;
+        const int64_t numSamples = (int64_t) (duracion * op.sampleRate);
+        int siguiente = 0;
+
+        for (int64_t pos = 0; pos < numSamples; pos += op.blockSize) {
+            const int n = (int) juce::jmin<int64_t>(op.blockSize, numSamples - pos);
+            const double fin = (double) (pos + n) / op.sampleRate;
+
+            midi.clear();
+            while (siguiente < secuencia.getNumEvents() && secuencia.getEventTime(siguiente) < fin) {
+                const auto& m = secuencia.getEventPointer(siguiente)->message;
+                const int offset = (int) juce::jlimit<int64_t>(0, n - 1, (int64_t) (m.getTimeStamp() * op.sampleRate) - pos);
+
+                if (m.isNoteOnOrOff() || m.isController() || m.isPitchWheel())
+                    midi.addEvent(m, offset);
+                siguiente++;
+            }
+
+            juce::AudioBuffer<float> bloque(buffer.getArrayOfWritePointers(), numChannels, n);
+            processor.processBlock(bloque, midi);
+            writer->writeFromAudioSampleBuffer(bloque, 0, n);
+        }
+
+        r.ok = true;
+        r.segundosAudio = duracion;
+        r.segundosRender = (juce::Time::getMillisecondCounterHiRes() - inicio) / 1000.0;
+        return r;
+    }
+
+    void informar(const juce::File& entrada, const Resultado& r)
+    {
+        static juce::CriticalSection lock;
+        const juce::ScopedLock sl(lock);
+
+        if (r.ok)
+            std::cout << entrada.getFileName() << ": " << juce::String(r.segundosAudio, 1) << " s en "
+                      << juce::String(r.segundosRender, 2) << " s (x" << juce::String(r.segundosAudio / juce::jmax(1.0e-6, r.segundosRender), 1)
+                      << " tiempo real)" << std::endl;
+        else
+            std::cerr << entrada.getFileName() << ": " << r.error << std::endl;
+    }
+
+    void uso()
+    {
+        std::cerr << "uso: harpejji_render <fichero.mid|directorio> [--out fichero|directorio] [--rate 48000]\n"
+                     "       [--format wav|flac] [--bits 16|24] [--quality n] [--block 512] [--tail 3]\n"
+                     "       [--tension 1.0] [--sustain 1.0] [--tone 5000] [--gain -12]\n"
+                     "       [--silence-floor -90] [--masking 0-1] [--jobs n]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const juce::ArgumentList args(argc, argv);
+    if (args.size() == 0 || args[0].isOption()) {
+        uso();
+        return 1;
+    }
+
+    Opciones op;
+    if (args.containsOption("--rate"))    op.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block"))   op.blockSize = args.getValueForOption("--block").getIntValue();
+    if (args.containsOption("--bits"))    op.bits = args.getValueForOption("--bits").getIntValue();
+    if (args.containsOption("--quality")) op.calidad = args.getValueForOption("--quality").getIntValue();
+    if (args.containsOption("--tail"))    op.cola = args.getValueForOption("--tail").getDoubleValue();
+    if (args.containsOption("--silence-floor")) op.pisoSilencio = args.getValueForOption("--silence-floor").getFloatValue();
+    if (args.containsOption("--masking")) op.enmascaramiento = args.getValueForOption("--masking").getFloatValue();
+    op.flac = args.getValueForOption("--format").equalsIgnoreCase("flac");
+
+    for (auto p : { "tension", "sustain", "tone", "gain" })
+        if (args.containsOption("--" + juce::String(p)))
+            op.parametros[juce::String(p).toUpperCase()] = args.getValueForOption("--" + juce::String(p)).getFloatValue();
+
+    if (op.sampleRate <= 0.0 || op.blockSize <= 0) {
+        uso();
+        return 1;
+    }
+
+    const juce::String extension = op.flac ? ".flac" : ".wav";
+    const auto entrada = juce::File::getCurrentWorkingDirectory().getChildFile(args[0].text);
+
+    // Un solo fichero
+    if (entrada.existsAsFile()) {
+        auto salida = args.containsOption("--out") ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--out"))
+                                                   : entrada.withFileExtension(extension);
+        if (salida.isDirectory())
+            salida = salida.getChildFile(entrada.getFileNameWithoutExtension() + extension);
+
+        const auto r = renderizar(entrada, salida, op);
+        informar(entrada, r);
+        return r.ok ? 0 : 1;
+    }
+
+    if (!entrada.isDirectory()) {
+        std::cerr << "no existe " << entrada.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // Batch: todos los .mid del directorio, un trabajo por núcleo
+    const auto ficheros = entrada.findChildFiles(juce::File::findFiles, false, "*.mid;*.midi");
+    const auto dirSalida = args.containsOption("--out") ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--out"))
+                                                        : entrada;
+    dirSalida.createDirectory();
+
+    const int numJobs = args.containsOption("--jobs") ? juce::jmax(1, args.getValueForOption("--jobs").getIntValue())
+                                                      : juce::SystemStats::getNumCpus();
+    std::atomic<int> errores { 0 };
+    const auto inicio = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool(numJobs);
+
+        for (const auto& f : ficheros) {
+            const auto salida = dirSalida.getChildFile(f.getFileNameWithoutExtension() + extension);
+
+            pool.addJob([f, salida, &op, &errores]
+            {
+                const auto r = renderizar(f, salida, op);
+                informar(f, r);
+                if (!r.ok)
+                    errores++;
+            });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(50);
+    }
+
+    std::cout << ficheros.size() << " ficheros en " << juce::String((juce::Time::getMillisecondCounterHiRes() - inicio) / 1000.0, 1)
+              << " s con " << numJobs << " trabajos" << std::endl;
+
+    return errores == 0 ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    RealtimeInterceptors.cpp
+    Created: 19 Oct 2026
+
+    Interceptores del build de comprobación de tiempo real. Reemplazan las
+    funciones de reserva de memoria, los locks de pthread y algunas llamadas
+    al sistema bloqueantes; si se llaman desde un hilo marcado con
+    rtcheck::ScopedAudioThread (es decir, dentro de processBlock) se cuenta una
+    infracción y se imprime la pila de llamadas.
+
+    Variables de entorno:
+      HARPEJJI_RT_ABORT=1          aborta en la primera infracción
+      HARPEJJI_RT_STRICT_LOCKS=1   también cuenta los locks que no han tenido que esperar
+
+    Sin HARPEJJI_RT_STRICT_LOCKS solo se cuenta un lock si ha tenido que
+    esperar a otro hilo; un lock sin contención (p. ej. el de juce::Synthesiser,
+    que nadie más toma) se informa una vez como aviso.
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined (__linux__) || defined (__APPLE__)
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+ #define HARPEJJI_RT_POSIX 1
+#endif
+
+#if defined (__has_feature)
+ #if __has_feature (address_sanitizer)
+  #define HARPEJJI_RT_ASAN 1
+ #endif
+#endif
+#if defined (__SANITIZE_ADDRESS__)
+ #define HARPEJJI_RT_ASAN 1
+#endif
+
+// Con glibc se interceptan malloc/free directamente (cubre también new/delete
+// y el código C). Con ASan, o fuera de glibc, solo new/delete.
+#if defined (__GLIBC__) && ! defined (HARPEJJI_RT_ASAN)
+ #define HARPEJJI_RT_MALLOC 1
+#endif
+
+namespace
+{
+    thread_local bool informando = false;           // Evita la recursión mientras se informa
+    std::atomic<int> numInformes { 0 };
+    std::atomic<bool> avisoLock { false };
+    constexpr int maxInformes = 32;                 // Pilas impresas; el contador sigue contando
+
+    bool abortar = false;
+    bool locksEstrictos = false;
+
+    void escribir(const char* texto)
+    {
+       #if HARPEJJI_RT_POSIX
+        ssize_t r = ::write(2, texto, std::strlen(texto));
+        (void) r;
+       #else
+        std::fputs(texto, stderr);
+       #endif
+    }
+
+    // backtrace carga libgcc la primera vez y reserva memoria; como se llama con
+    // 'informando' activado, esas reservas no cuentan como infracción
+    void imprimirPila()
+    {
+       #if HARPEJJI_RT_POSIX
+        void* pila[64];
+        const int n = backtrace(pila, 64);
+        backtrace_symbols_fd(pila + 2, n > 2 ? n - 2 : 0, 2);
+       #endif
+    }
+
+    // Devuelve true si se trataba de una infracción
+    bool informar(const char* que, bool cuenta = true)
+    {
+        if (informando || !rtcheck::isAudioThread())
+            return false;
+
+        informando = true;
+
+        if (cuenta) {
+            rtcheck::addViolation();
+
+            if (numInformes++ < maxInformes) {
+                escribir("\n[rtcheck] ");
+                escribir(que);
+                escribir(" en el hilo de audio\n");
+                imprimirPila();
+            }
+
+            if (abortar)
+                std::abort();
+        }
+        else if (!avisoLock.exchange(true)) {
+            escribir("\n[rtcheck] aviso: ");
+            escribir(que);
+            escribir(" sin contención en el hilo de audio (HARPEJJI_RT_STRICT_LOCKS=1 para contarlo)\n");
+            imprimirPila();
+        }
+
+        informando = false;
+        return cuenta;
+    }
+}
+
+//==============================================================================
+// Memoria
+
+#if HARPEJJI_RT_MALLOC
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void  __libc_free(void*);
+
+    void* malloc(size_t size)                   { informar("malloc"); return __libc_malloc(size); }
+    void* calloc(size_t n, size_t size)         { informar("calloc"); return __libc_calloc(n, size); }
+    void* realloc(void* p, size_t size)         { informar("realloc"); return __libc_realloc(p, size); }
+    void* memalign(size_t al, size_t size)      { informar("memalign"); return __libc_memalign(al, size); }
+    void* aligned_alloc(size_t al, size_t size) { informar("aligned_alloc"); return __libc_memalign(al, size); }
+    void  free(void* p)                         { if (p != nullptr) informar("free"); __libc_free(p); }
+
+    int posix_memalign(void** res, size_t al, size_t size)
+    {
+        informar("posix_memalign");
+        *res = __libc_memalign(al, size);
+        return *res != nullptr ? 0 : ENOMEM;
+    }
+}
+
+#else
+
+namespace
+{
+    void* reservar(std::size_t size)
+    {
+        informar("operator new");
+        if (void* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void liberar(void* p) noexcept
+    {
+        if (p != nullptr)
+            informar("operator delete");
+        std::free(p);
+    }
+}
+
+void* operator new(std::size_t size)                                    { return reservar(size); }
+void* operator new[](std::size_t size)                                  { return reservar(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept    { try { return reservar(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept  { try { return reservar(size); } catch (...) { return nullptr; } }
+void  operator delete(void* p) noexcept                                 { liberar(p); }
+void  operator delete[](void* p) noexcept                               { liberar(p); }
+void  operator delete(void* p, std::size_t) noexcept                    { liberar(p); }
+void  operator delete[](void* p, std::size_t) noexcept                  { liberar(p); }
+
+#endif
+
+//==============================================================================
+// Locks y llamadas al sistema bloqueantes
+
+#if HARPEJJI_RT_POSIX
+
+namespace
+{
+    // Función original (la siguiente en el orden de carga). Se resuelve la primera vez que se
+    // usa, no en un constructor: el programa y otras librerías pueden llamar a estas funciones
+    // antes de que se ejecuten los constructores de este fichero. Con inicialización constante
+    // el puntero ya es nulo en ese momento; si dos hilos lo resuelven a la vez, ambos obtienen
+    // el mismo valor
+    template <typename Fn>
+    struct Original
+    {
+        const char* nombre;
+        std::atomic<void*> fn { nullptr };
+
+        Fn get() noexcept
+        {
+            void* f = fn.load(std::memory_order_acquire);
+            if (f == nullptr) {
+                f = dlsym(RTLD_NEXT, nombre);
+                fn.store(f, std::memory_order_release);
+            }
+            return reinterpret_cast<Fn>(f);
+        }
+    };
+
+    namespace originales
+    {
+        Original<int (*)(pthread_mutex_t*)> mutexLock { "pthread_mutex_lock" };
+        Original<int (*)(pthread_mutex_t*)> mutexTryLock { "pthread_mutex_trylock" };
+        Original<int (*)(pthread_rwlock_t*)> rwRdLock { "pthread_rwlock_rdlock" };
+        Original<int (*)(pthread_rwlock_t*)> rwWrLock { "pthread_rwlock_wrlock" };
+        Original<int (*)(pthread_cond_t*, pthread_mutex_t*)> condWait { "pthread_cond_wait" };
+        Original<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)> condTimedWait { "pthread_cond_timedwait" };
+        Original<int (*)(sem_t*)> semWait { "sem_wait" };
+        Original<int (*)(const struct timespec*, struct timespec*)> nanosleep { "nanosleep" };
+        Original<int (*)(useconds_t)> usleep { "usleep" };
+        Original<unsigned int (*)(unsigned int)> sleep { "sleep" };
+        Original<ssize_t (*)(int, void*, size_t)> read { "read" };
+        Original<ssize_t (*)(int, const void*, size_t)> write { "write" };
+        Original<int (*)(const char*, int, ...)> open { "open" };
+        Original<int (*)(int)> close { "close" };
+        Original<int (*)(int)> fsync { "fsync" };
+        Original<int (*)(struct pollfd*, nfds_t, int)> poll { "poll" };
+    }
+
+    // Solo lee las opciones: las funciones originales se resuelven al usarlas
+    __attribute__((constructor)) void inicializar()
+    {
+        abortar = std::getenv("HARPEJJI_RT_ABORT") != nullptr;
+        locksEstrictos = std::getenv("HARPEJJI_RT_STRICT_LOCKS") != nullptr;
+    }
+}
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* m)
+    {
+        if (rtcheck::isAudioThread() && !informando) {
+            if (originales::mutexTryLock.get()(m) == 0) {
+                informar("pthread_mutex_lock", locksEstrictos);
+                return 0;
+            }
+            informar("pthread_mutex_lock con contención (el hilo de audio espera a otro hilo)");
+        }
+        return originales::mutexLock.get()(m);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* l)                      { informar("pthread_rwlock_rdlock", locksEstrictos); return originales::rwRdLock.get()(l); }
+    int pthread_rwlock_wrlock(pthread_rwlock_t* l)                      { informar("pthread_rwlock_wrlock", locksEstrictos); return originales::rwWrLock.get()(l); }
+    int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)        { informar("pthread_cond_wait"); return originales::condWait.get()(c, m); }
+    int pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+                                                                        { informar("pthread_cond_timedwait"); return originales::condTimedWait.get()(c, m, t); }
+    int sem_wait(sem_t* s)                                              { informar("sem_wait"); return originales::semWait.get()(s); }
+    int nanosleep(const struct timespec* t, struct timespec* r)         { informar("nanosleep"); return originales::nanosleep.get()(t, r); }
+    int usleep(useconds_t us)                                           { informar("usleep"); return originales::usleep.get()(us); }
+    unsigned int sleep(unsigned int s)                                  { informar("sleep"); return originales::sleep.get()(s); }
+    ssize_t read(int fd, void* buf, size_t n)                           { informar("read"); return originales::read.get()(fd, buf, n); }
+    ssize_t write(int fd, const void* buf, size_t n)                    { informar("write"); return originales::write.get()(fd, buf, n); }
+    int close(int fd)                                                   { informar("close"); return originales::close.get()(fd); }
+    int fsync(int fd)                                                   { informar("fsync"); return originales::fsync.get()(fd); }
+    int poll(struct pollfd* fds, nfds_t n, int timeout)                 { informar("poll"); return originales::poll.get()(fds, n, timeout); }
+
+    int open(const char* path, int flags, ...)
+    {
+        informar("open");
+
+        mode_t mode = 0;
+        if ((flags & O_CREAT) != 0) {
+            va_list args;
+            va_start(args, flags);
+            mode = (mode_t) va_arg(args, int);
+            va_end(args);
+        }
+        return originales::open.get()(path, flags, mode);
+    }
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    Main.cpp (harpejji_stress)
+    Created: 19 Oct 2026
+
+    Host aleatorio para buscar el peor caso y fallos de robustez del
+    SynthAudioProcessor: tamaños de bloque de 1 a varios miles, cambios de
+    frecuencia de muestreo entre llamadas a prepareToPlay, tormentas MIDI
+    (decenas de note on por bloque, notas fuera del rango que acepta
+    SynthVoice::startNote) y automatización aleatoria de todos los parámetros.
+
+    Falla si la salida no es finita o si los interceptores de Tools/RtCheck
+    detectan reservas de memoria, locks con espera o llamadas al sistema
+    bloqueantes dentro de processBlock (--allow-alloc solo las informa).
+    Pensado para ejecutarse también con sanitizers
+    (cmake -DHARPEJJI_SANITIZERS=address,undefined).
+
+    harpejji_stress [--iterations n] [--seed s] [--max-block n] [--allow-alloc]
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include <csignal>
+
+//==============================================================================
+
+namespace
+{
+    // Estado que se imprime si el proceso recibe una señal fatal, para poder reproducir el fallo
+    volatile std::sig_atomic_t iteracionActual = -1;
+    std::uint64_t semillaActual = 0;
+
+    extern "C" void alFallar(int sig)
+    {
+        std::fprintf(stderr, "\nCRASH: senal %d en la iteracion %d (semilla %llu)\n",
+                     sig, (int) iteracionActual, (unsigned long long) semillaActual);
+        std::signal(sig, SIG_DFL);
+        std::raise(sig);
+    }
+
+    const double sampleRates[] = { 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+    int bloqueAleatorio(juce::Random& rnd, int maxBlock)
+    {
+        // La mitad de las veces bloques pequeños (1-64), que son los más difíciles para la temporización
+        return rnd.nextBool() ? 1 + rnd.nextInt(juce::jmin(64, maxBlock)) : 1 + rnd.nextInt(maxBlock);
+    }
+
+    void midiAleatorio(juce::Random& rnd, juce::MidiBuffer& midi, int numSamples)
+    {
+        midi.clear();
+
+        const int tipo = rnd.nextInt(10);
+        const int numEventos = tipo == 0 ? 24 + rnd.nextInt(48)        // Tormenta MIDI
+                             : tipo < 4  ? rnd.nextInt(4)
+                             : 0;
+
+        for (int i = 0; i < numEventos; i++) {
+            const int pos = rnd.nextInt(numSamples);
+            const int nota = rnd.nextInt(10) == 0 ? rnd.nextInt(128)   // Incluye notas fuera de 65.4-1047 Hz
+                                                  : 36 + rnd.nextInt(49);
+
+            switch (rnd.nextInt(5)) {
+                case 0:  midi.addEvent(juce::MidiMessage::noteOff(1, nota), pos); break;
+                case 1:  midi.addEvent(juce::MidiMessage::pitchWheel(1, rnd.nextInt(16384)), pos); break;
+                case 2:  midi.addEvent(juce::MidiMessage::controllerEvent(1, rnd.nextInt(128), rnd.nextInt(128)), pos); break;
+                default: midi.addEvent(juce::MidiMessage::noteOn(1, nota, (juce::uint8) (1 + rnd.nextInt(127))), pos); break;
+            }
+        }
+    }
+
+    void automatizar(juce::Random& rnd, SynthAudioProcessor& processor)
+    {
+        for (auto* p : processor.getParameters())
+            if (rnd.nextInt(4) == 0)
+                p->setValueNotifyingHost(rnd.nextFloat());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const juce::ArgumentList args(argc, argv);
+    const int iteraciones = args.containsOption("--iterations") ? args.getValueForOption("--iterations").getIntValue() : 10000;
+    const int maxBlock = args.containsOption("--max-block") ? juce::jmax(1, args.getValueForOption("--max-block").getIntValue()) : 4096;
+    const bool permitirReservas = args.containsOption("--allow-alloc");
+    semillaActual = args.containsOption("--seed") ? (std::uint64_t) args.getValueForOption("--seed").getLargeIntValue()
+                                                  : (std::uint64_t) juce::Time::currentTimeMillis();
+
+    std::signal(SIGSEGV, alFallar);
+    std::signal(SIGFPE, alFallar);
+    std::signal(SIGABRT, alFallar);
+    std::signal(SIGILL, alFallar);
+
+    std::cout << "semilla " << semillaActual << std::endl;
+
+    juce::Random rnd((juce::int64) semillaActual);
+    SynthAudioProcessor processor;
+
+    double sampleRate = 48000.0;
+    int blockSize = maxBlock;
+    juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), maxBlock);
+    juce::MidiBuffer midi;
+
+    int numNoFinitos = 0, numPrepares = 0;
+    int64_t bloquesConInfracciones = 0;
+    const long infraccionesIniciales = rtcheck::getNumViolations();
+    double peorCarga = 0.0, peorTiempo = 0.0;
+    int peorBloque = 0;
+
+    for (int it = 0; it < iteraciones; it++) {
+        iteracionActual = it;
+
+        // Cambio de frecuencia de muestreo / tamaño máximo de bloque, como al reconfigurar el host
+        if (it == 0 || rnd.nextInt(200) == 0) {
+            sampleRate = sampleRates[rnd.nextInt((int) std::size(sampleRates))];
+            blockSize = 1 + rnd.nextInt(maxBlock);
+            processor.releaseResources();
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+            numPrepares++;
+        }
+
+        const int n = juce::jmin(blockSize, bloqueAleatorio(rnd, maxBlock));
+        juce::AudioBuffer<float> bloque(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), n);
+
+        midiAleatorio(rnd, midi, n);
+        automatizar(rnd, processor);
+
+        const auto infraccionesAntes = rtcheck::getNumViolations();
+        const auto t0 = juce::Time::getHighResolutionTicks();
+
+        processor.processBlock(bloque, midi);
+
+        const double t = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0);
+
+        if (rtcheck::getNumViolations() != infraccionesAntes)
+            bloquesConInfracciones++;
+
+        const double carga = t * sampleRate / n;
+        if (carga > peorCarga) {
+            peorCarga = carga;
+            peorTiempo = t;
+            peorBloque = n;
+        }
+
+        for (int ch = 0; ch < bloque.getNumChannels(); ch++)
+            for (int s = 0; s < n; s++)
+                if (!std::isfinite(bloque.getSample(ch, s))) {
+                    numNoFinitos++;
+                    ch = bloque.getNumChannels();
+                    break;
+                }
+    }
+
+    std::cout << iteraciones << " bloques, " << numPrepares << " prepareToPlay" << std::endl
+              << "peor bloque: " << 1.0e6 * peorTiempo << " us para " << peorBloque << " samples (carga "
+              << juce::String(100.0 * peorCarga, 1) << " %)" << std::endl
+              << "bloques con salida no finita: " << numNoFinitos << std::endl
+              << "bloques con infracciones de tiempo real: " << bloquesConInfracciones
+              << " (" << rtcheck::getNumViolations() - infraccionesIniciales << " en total)" << std::endl;
+
+    const bool ok = numNoFinitos == 0 && (permitirReservas || bloquesConInfracciones == 0);
+    std::cout << (ok ? "OK" : "FALLO") << std::endl;
+    return ok ? 0 : 1;
+}